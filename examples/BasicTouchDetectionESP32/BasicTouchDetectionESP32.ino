@@ -7,6 +7,11 @@
  * This example demonstrates basic touch detection and coordinate reading
  * from the IQS5XX-B000 trackpad sensor.
  * 
+ * Set BINARY_STREAM to 1 to send every frame (up to five fingers) as a
+ * compact binary packet instead of CSV text, fast enough for the full
+ * report rate at 115200 baud. Decode it with IQS5XX_StreamDecoder, e.g.
+ * extras/host/stream_decode.
+ * 
  * Hardware Connections:
  * - VCC: 3.3V or 5V
  * - GND: Ground
@@ -20,6 +25,7 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <IQS5XX_B000_Trackpad.h>
+#include <IQS5XX_TouchStream.h>
 
 
 
@@ -28,9 +34,15 @@
 #define IQS550_RDY_PIN 39 // Ready signal pin
 #define IQS550_RST_PIN 40 // Reset pin
 
+// 0: CSV text "x,y,strength,area", 1: binary frames (IQS5XX_Stream.h)
+#define BINARY_STREAM 0
+
 // Create trackpad instance with default I2C address
 IQS5XX_B000_Trackpad trackpad(IQS550_RDY_PIN, IQS5XX_DEFAULT_ADDRESS);
 
+// Binary frame writer on the serial port
+IQS5XX_TouchStream touchStream(Serial);
+
 void setup() {
   // Initialize serial communication
   Serial.begin(115200);
@@ -63,9 +75,15 @@ void setup() {
     Serial.println(versionInfo, HEX);
     Serial.println();
     
+#if BINARY_STREAM
+    // Report every 5 ms; the decoder skips the text above at the first delimiter
+    trackpad.increaseSpeed();
+    trackpad.setEndWindowAfterRead(true);
+#else
     Serial.println("Touch the trackpad to see coordinates...");
     Serial.println("Format: X: 0 - 1023, Y: 0 - 1023, Strength: xxx, Area: xxx");
     Serial.println();
+#endif
 
 
   } else {
@@ -78,6 +96,13 @@ void setup() {
 }
 
 void loop() {
+#if BINARY_STREAM
+  // One packet per frame, paced by RDY instead of a delay
+  MultiTouchFrame frame;
+  if (trackpad.readMultiTouch(frame)) {
+    touchStream.write(frame, micros());
+  }
+#else
   // Read touch data
   TouchData touchData;
   
@@ -99,4 +124,5 @@ void loop() {
   
   // Small delay to avoid overwhelming the serial output
   delay(50);
-}
\ No newline at end of file
+#endif
+}
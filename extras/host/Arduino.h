@@ -0,0 +1,163 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal host (Linux) stand-in for the Arduino core
+ * @author lemio
+ *
+ * Provides just enough of the Arduino API for the library to build on a
+ * desktop. Time is virtual: delay()/delayMicroseconds() and bus traffic
+ * advance a simulated clock, and pins are driven by simulated devices
+ * (see IQS5XX_Simulator.h) instead of hardware.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define DEC 10
+#define HEX 16
+
+#define IRAM_ATTR
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef void (*voidFuncPtr)(void);
+
+#define digitalPinToInterrupt(p) (p)
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void attachInterrupt(uint8_t interruptNum, voidFuncPtr handler, int mode);
+void detachInterrupt(uint8_t interruptNum);
+void interrupts();
+void noInterrupts();
+
+/**
+ * @class Print
+ * @brief Subset of the Arduino Print interface
+ */
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    size_t println(const char* str);
+    size_t println(char c);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+
+  private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial port that writes to stdout
+ */
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long baud) { (void)baud; }
+    operator bool() const { return true; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+namespace host {
+
+/**
+ * @class Device
+ * @brief Simulated peripheral stepped by the virtual clock
+ */
+class Device {
+  public:
+    virtual ~Device() {}
+    /**
+     * @brief Bring the device state up to date with the virtual clock
+     * @param nowUs Current virtual time in microseconds
+     */
+    virtual void tick(uint64_t nowUs) = 0;
+};
+
+/**
+ * @brief Current virtual time in microseconds
+ */
+uint64_t nowUs();
+
+/**
+ * @brief Advance the virtual clock, stepping all attached devices
+ * @param us Microseconds to advance
+ */
+void advanceUs(uint64_t us);
+
+/**
+ * @brief Advance the virtual clock to an absolute time (no-op if in the past)
+ * @param us Absolute virtual time in microseconds
+ */
+void advanceToUs(uint64_t us);
+
+/**
+ * @brief Register a device to be stepped whenever the clock advances
+ * @param device Device to attach (not owned)
+ */
+void attachDevice(Device* device);
+
+/**
+ * @brief Unregister a device
+ * @param device Device previously passed to attachDevice()
+ */
+void detachDevice(Device* device);
+
+/**
+ * @brief Drive a pin from a simulated device, firing interrupts on edges
+ * @param pin Pin number
+ * @param level HIGH or LOW
+ */
+void setPin(uint8_t pin, int level);
+
+/**
+ * @brief Reset virtual time, pins, interrupts and attached devices
+ */
+void reset();
+
+} // namespace host
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,227 @@
+/**
+ * @file HostArduino.cpp
+ * @brief Virtual clock, pins and Serial for the host Arduino stand-in
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "Arduino.h"
+
+#include <stdio.h>
+
+namespace {
+
+const uint8_t MAX_PINS = 64;
+const uint8_t MAX_DEVICES = 8;
+
+uint64_t g_nowUs = 0;
+bool g_advancing = false;
+
+uint8_t g_pinLevel[MAX_PINS];
+voidFuncPtr g_pinHandler[MAX_PINS];
+int g_pinMode[MAX_PINS];
+bool g_interruptsEnabled = true;
+
+host::Device* g_devices[MAX_DEVICES];
+uint8_t g_deviceCount = 0;
+
+struct PinInit {
+  PinInit() { host::reset(); }
+} g_pinInit;
+
+} // namespace
+
+HardwareSerial Serial;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= MAX_PINS) {
+    return LOW;
+  }
+  return g_pinLevel[pin];
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  host::setPin(pin, value ? HIGH : LOW);
+}
+
+unsigned long millis() {
+  return (unsigned long)(g_nowUs / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)g_nowUs;
+}
+
+void delay(unsigned long ms) {
+  host::advanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  host::advanceUs(us);
+}
+
+void attachInterrupt(uint8_t interruptNum, voidFuncPtr handler, int mode) {
+  if (interruptNum >= MAX_PINS) {
+    return;
+  }
+  g_pinHandler[interruptNum] = handler;
+  g_pinMode[interruptNum] = mode;
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  if (interruptNum >= MAX_PINS) {
+    return;
+  }
+  g_pinHandler[interruptNum] = nullptr;
+}
+
+void interrupts() {
+  g_interruptsEnabled = true;
+}
+
+void noInterrupts() {
+  g_interruptsEnabled = false;
+}
+
+namespace host {
+
+uint64_t nowUs() {
+  return g_nowUs;
+}
+
+void advanceUs(uint64_t us) {
+  advanceToUs(g_nowUs + us);
+}
+
+void advanceToUs(uint64_t us) {
+  if (us > g_nowUs) {
+    g_nowUs = us;
+  }
+  // Devices may advance the clock themselves (e.g. from an interrupt
+  // handler doing bus traffic); do not re-enter the tick loop
+  if (g_advancing) {
+    return;
+  }
+  g_advancing = true;
+  for (uint8_t i = 0; i < g_deviceCount; i++) {
+    g_devices[i]->tick(g_nowUs);
+  }
+  g_advancing = false;
+}
+
+void attachDevice(Device* device) {
+  for (uint8_t i = 0; i < g_deviceCount; i++) {
+    if (g_devices[i] == device) {
+      return;
+    }
+  }
+  if (g_deviceCount < MAX_DEVICES) {
+    g_devices[g_deviceCount++] = device;
+  }
+}
+
+void detachDevice(Device* device) {
+  for (uint8_t i = 0; i < g_deviceCount; i++) {
+    if (g_devices[i] == device) {
+      g_devices[i] = g_devices[--g_deviceCount];
+      return;
+    }
+  }
+}
+
+void setPin(uint8_t pin, int level) {
+  if (pin >= MAX_PINS) {
+    return;
+  }
+  uint8_t previous = g_pinLevel[pin];
+  g_pinLevel[pin] = level ? HIGH : LOW;
+  if (previous == g_pinLevel[pin] || g_pinHandler[pin] == nullptr || !g_interruptsEnabled) {
+    return;
+  }
+
+  int mode = g_pinMode[pin];
+  bool falling = (g_pinLevel[pin] == LOW);
+  if (mode == CHANGE || (mode == FALLING && falling) || (mode == RISING && !falling)) {
+    g_pinHandler[pin]();
+  }
+}
+
+void reset() {
+  g_nowUs = 0;
+  g_advancing = false;
+  g_interruptsEnabled = true;
+  g_deviceCount = 0;
+  for (uint8_t i = 0; i < MAX_PINS; i++) {
+    g_pinLevel[i] = HIGH;
+    g_pinHandler[i] = nullptr;
+    g_pinMode[i] = 0;
+  }
+}
+
+} // namespace host
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+  char buffer[8 * sizeof(long) + 1];
+  char* p = &buffer[sizeof(buffer) - 1];
+  *p = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    unsigned long digit = value % base;
+    value /= base;
+    *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+  } while (value);
+  return write(p);
+}
+
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(int value, int base) { return print((long)value, base); }
+size_t Print::print(unsigned int value, int base) { return print((unsigned long)value, base); }
+
+size_t Print::print(long value, int base) {
+  if (base == 10 && value < 0) {
+    return print('-') + printNumber((unsigned long)(-value), 10);
+  }
+  return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) { return printNumber(value, base); }
+
+size_t Print::print(double value, int digits) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const char* str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(int value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned int value, int base) { return print(value, base) + println(); }
+size_t Print::println(long value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned long value, int base) { return print(value, base) + println(); }
+size_t Print::println(double value, int digits) { return print(value, digits) + println(); }
+
+size_t HardwareSerial::write(uint8_t c) {
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  return fwrite(buffer, 1, size, stdout);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file HostAsyncI2C.cpp
+ * @brief Asynchronous I2C backend on the host bus model
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "HostAsyncI2C.h"
+
+HostAsyncI2C::HostAsyncI2C(TwoWire &wire) : _wire(&wire), _blocking(wire) {
+  _current = nullptr;
+  _doneAtUs = 0;
+  host::attachDevice(this);
+}
+
+HostAsyncI2C::~HostAsyncI2C() {
+  host::detachDevice(this);
+}
+
+bool HostAsyncI2C::submit(IQS5XX_I2CTransfer &transfer) {
+  if (_current != nullptr || transfer.txLength > IQS5XX_I2C_MAX_WRITE ||
+      (transfer.rxLength > 0 && transfer.rx == nullptr)) {
+    return false;
+  }
+
+  // Same phases as IQS5XX_WireI2C: START + address + data + STOP each
+  uint64_t bits = 0;
+  if (transfer.txLength > 0) {
+    bits += 1 + 9 + 9 * (uint64_t)transfer.txLength + 1;
+  }
+  if (transfer.rxLength > 0) {
+    bits += 1 + 9 + 9 * (uint64_t)transfer.rxLength + 1;
+  }
+
+  transfer.status = I2C_TRANSFER_BUSY;
+  _current = &transfer;
+  _doneAtUs = host::nowUs() + (uint64_t)(host::wireTimeUs(bits, _wire->getClock()) + 0.5);
+  return true;
+}
+
+void HostAsyncI2C::tick(uint64_t nowUs) {
+  if (_current == nullptr || nowUs < _doneAtUs) {
+    return;
+  }
+
+  // The wire time has already passed on the virtual clock
+  IQS5XX_I2CTransfer* transfer = _current;
+  _current = nullptr;
+  _wire->setAdvanceClock(false);
+  _blocking.submit(*transfer);
+  _wire->setAdvanceClock(true);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file HostAsyncI2C.h
+ * @brief Asynchronous I2C backend on the host bus model
+ * @author lemio
+ *
+ * Behaves like a DMA/interrupt driven I2C controller: submit() returns at
+ * once, the transfer runs on the simulated bus once its modeled wire time
+ * has elapsed on the virtual clock, and completion (status and callback)
+ * is signalled from the clock tick, i.e. "from the interrupt".
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef HOST_ASYNC_I2C_H
+#define HOST_ASYNC_I2C_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "IQS5XX_AsyncI2C.h"
+
+/**
+ * @class HostAsyncI2C
+ * @brief IQS5XX_I2CBackend that completes transfers from the virtual clock
+ */
+class HostAsyncI2C : public IQS5XX_I2CBackend, public host::Device {
+  public:
+    /**
+     * @brief Constructor, attaches to the virtual clock
+     * @param wire Host TwoWire with the simulated devices
+     */
+    explicit HostAsyncI2C(TwoWire &wire);
+    ~HostAsyncI2C();
+
+    bool submit(IQS5XX_I2CTransfer &transfer) override;
+    bool busy() const override { return _current != nullptr; }
+
+    // host::Device
+    void tick(uint64_t nowUs) override;
+
+  private:
+    TwoWire* _wire;
+    IQS5XX_WireI2C _blocking;
+    IQS5XX_I2CTransfer* _current;
+    uint64_t _doneAtUs;
+};
+
+#endif // HOST_ASYNC_I2C_H
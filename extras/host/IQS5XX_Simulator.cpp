@@ -0,0 +1,380 @@
+/**
+ * @file IQS5XX_Simulator.cpp
+ * @brief Register-level simulation of an IQS5XX-B000 trackpad for host builds
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Simulator.h"
+
+// Wake-up time after the sleep NACK (datasheet: at least 150us)
+#define IQS5XX_SIM_WAKE_US 150
+
+IQS5XX_Simulator::IQS5XX_Simulator(uint8_t readyPin, uint8_t address, uint16_t productNumber) {
+  _readyPin = readyPin;
+  _address = address;
+  _productNumber = productNumber;
+  _conversionUs = 1000;
+  _strokeCount = 0;
+  _gestureCount = 0;
+  _fault = IQS5XX_SIM_FAULT_NACK;
+  _faultCount = 0;
+  _faultsHit = 0;
+  setNoise(0);
+  powerOn();
+}
+
+void IQS5XX_Simulator::attach(TwoWire &wire) {
+  wire.attachDevice(this);
+  host::attachDevice(this);
+  powerOn();
+}
+
+void IQS5XX_Simulator::powerOn() {
+  memset(_mem, 0, sizeof(_mem));
+  setReg16(IQS5XX_REG_PRODUCT_NUMBER, _productNumber);
+  _mem[IQS5XX_REG_MAJOR_VERSION] = 2;
+  _mem[IQS5XX_REG_MINOR_VERSION] = 0;
+  _mem[IQS5XX_REG_SYSTEM_INFO_0] = IQS5XX_SYS_INFO0_SHOW_RESET;
+
+  // Datasheet defaults for the timing registers
+  setReg16(IQS5XX_REG_ACTIVE_REPORT_RATE, 10);
+  setReg16(IQS5XX_REG_IDLE_TOUCH_REPORT_RATE, 50);
+  setReg16(IQS5XX_REG_IDLE_REPORT_RATE, 50);
+  _mem[IQS5XX_REG_ACTIVE_TIMEOUT] = 1;
+  _mem[IQS5XX_REG_I2C_TIMEOUT] = 10;
+  // All gestures enabled
+  _mem[IQS5XX_REG_SINGLE_FINGER_GESTURES] = IQS5XX_SINGLE_FINGER_GESTURES_ALL;
+  _mem[IQS5XX_REG_MULTI_FINGER_GESTURES] = IQS5XX_MULTI_FINGER_GESTURES_ALL;
+
+  _pointer = 0;
+  _state = SENSING;
+  _cycleStartUs = host::nowUs();
+  _lastActivityUs = _cycleStartUs;
+  _wakeAtUs = 0;
+  _lastTouchUs = _cycleStartUs;
+  _windows = 0;
+  _skipped = 0;
+  _reseeds = 0;
+  _forceWindow = false;
+  _fingers = 0;
+  _reportedFingers = 0;
+  _lastStrokeInSlot0 = -1;
+  _lastX0 = 0;
+  _lastY0 = 0;
+  host::setPin(_readyPin, HIGH);
+}
+
+void IQS5XX_Simulator::sleep() {
+  _state = SLEEP;
+  _wakeAtUs = 0;
+  host::setPin(_readyPin, HIGH);
+}
+
+bool IQS5XX_Simulator::addStroke(const IQS5XX_Stroke &stroke) {
+  if (_strokeCount >= IQS5XX_SIM_MAX_STROKES) {
+    return false;
+  }
+  _strokes[_strokeCount++] = stroke;
+  return true;
+}
+
+bool IQS5XX_Simulator::addGesture(uint64_t atUs, uint8_t events0, uint8_t events1) {
+  if (_gestureCount >= IQS5XX_SIM_MAX_GESTURES) {
+    return false;
+  }
+  Gesture &gesture = _gestures[_gestureCount++];
+  gesture.atUs = atUs;
+  gesture.events0 = events0;
+  gesture.events1 = events1;
+  gesture.reported = false;
+  return true;
+}
+
+void IQS5XX_Simulator::injectFault(IQS5XX_SimFault fault, uint8_t count) {
+  _fault = fault;
+  _faultCount = count;
+}
+
+void IQS5XX_Simulator::setNoise(uint16_t amplitude, uint32_t seed) {
+  _noiseAmplitude = amplitude;
+  _noiseState = (seed != 0) ? seed : 1;
+}
+
+int32_t IQS5XX_Simulator::noise() {
+  if (_noiseAmplitude == 0) {
+    return 0;
+  }
+  _noiseState ^= _noiseState << 13;
+  _noiseState ^= _noiseState >> 17;
+  _noiseState ^= _noiseState << 5;
+  return (int32_t)(_noiseState % (2u * _noiseAmplitude + 1)) - _noiseAmplitude;
+}
+
+void IQS5XX_Simulator::clearScript() {
+  _strokeCount = 0;
+  _gestureCount = 0;
+}
+
+void IQS5XX_Simulator::setReg16(uint16_t reg, uint16_t value) {
+  _mem[reg] = (value >> 8) & 0xFF;
+  _mem[(uint16_t)(reg + 1)] = value & 0xFF;
+}
+
+void IQS5XX_Simulator::tick(uint64_t nowUs) {
+  if (_state == SLEEP) {
+    // Woken by a NACKed access; sensing restarts after the wake-up time
+    if (_wakeAtUs == 0 || nowUs < _wakeAtUs) {
+      return;
+    }
+    _state = SENSING;
+    _cycleStartUs = _wakeAtUs;
+  }
+  // Catch up on every window edge that happened up to nowUs
+  for (;;) {
+    if (_state == SENSING && nowUs >= windowOpensAt()) {
+      uint64_t at = windowOpensAt();
+      sample(at);
+      if (eventPending()) {
+        openWindow(at);
+      } else {
+        // Event mode: nothing to report, sense again without asserting RDY
+        _skipped++;
+        uint64_t period = reportPeriodUs(at);
+        _cycleStartUs += (period > _conversionUs) ? period : _conversionUs;
+      }
+    } else if (_state == WINDOW && nowUs >= windowClosesAt()) {
+      closeWindow(windowClosesAt());
+    } else {
+      break;
+    }
+  }
+}
+
+uint64_t IQS5XX_Simulator::i2cReadyAt(uint64_t nowUs) {
+  // Outside the window the device holds SCL low until it can respond,
+  // opening the next window even if event mode has nothing to report
+  if (_state == SENSING && nowUs < windowOpensAt()) {
+    _forceWindow = true;
+    return windowOpensAt();
+  }
+  return nowUs;
+}
+
+bool IQS5XX_Simulator::eventPending() const {
+  uint8_t config = _mem[IQS5XX_REG_SYS_CFG1];
+  if (!(config & IQS5XX_EVENT_MODE) || _forceWindow) {
+    return true;
+  }
+  if ((config & IQS5XX_EVENT_TP) && (_fingers != 0 || _fingers != _reportedFingers)) {
+    return true;
+  }
+  if ((config & IQS5XX_EVENT_GESTURE) &&
+      (_mem[IQS5XX_SYS_GESTURE_EVENTS_0] != 0 || _mem[IQS5XX_SYS_GESTURE_EVENTS_1] != 0)) {
+    return true;
+  }
+  return false;
+}
+
+uint8_t IQS5XX_Simulator::i2cWrite(const uint8_t* data, size_t length, bool stop) {
+  (void)stop;
+  uint64_t now = host::nowUs();
+  if (_state == SLEEP) {
+    // The address byte wakes the device but is not acknowledged
+    if (_wakeAtUs == 0) {
+      _wakeAtUs = now + IQS5XX_SIM_WAKE_US;
+    }
+    return 2;
+  }
+  if (_faultCount > 0 && _fault == IQS5XX_SIM_FAULT_NACK) {
+    _faultCount--;
+    _faultsHit++;
+    return 2;
+  }
+  _lastActivityUs = now;
+
+  if (length == 0) {
+    return 0;
+  }
+  if (length == 1) {
+    // The device only supports 16-bit addressing; treat a lone byte as a
+    // short address so legacy 8-bit helpers read something predictable
+    _pointer = data[0];
+    return 0;
+  }
+
+  _pointer = (data[0] << 8) | data[1];
+  if (_pointer == IQS5XX_REG_END_COMM_WINDOW) {
+    // Release RDY and start the next cycle without waiting for the timeout
+    if (_state == WINDOW) {
+      closeWindow(now);
+    }
+    return 0;
+  }
+  for (size_t i = 2; i < length; i++) {
+    onRegisterWrite(_pointer, data[i]);
+    _pointer++;
+  }
+  return 0;
+}
+
+size_t IQS5XX_Simulator::i2cRead(uint8_t* data, size_t length, bool stop) {
+  (void)stop;
+  if (_state == SLEEP) {
+    if (_wakeAtUs == 0) {
+      _wakeAtUs = host::nowUs() + IQS5XX_SIM_WAKE_US;
+    }
+    return 0;
+  }
+  if (_faultCount > 0) {
+    _faultCount--;
+    _faultsHit++;
+    if (_fault == IQS5XX_SIM_FAULT_NACK) {
+      return 0;
+    }
+    length /= 2;
+  }
+  _lastActivityUs = host::nowUs();
+  for (size_t i = 0; i < length; i++) {
+    data[i] = _mem[_pointer++];
+  }
+  return length;
+}
+
+uint64_t IQS5XX_Simulator::windowClosesAt() const {
+  uint8_t timeoutMs = _mem[IQS5XX_REG_I2C_TIMEOUT];
+  return _lastActivityUs + (uint64_t)(timeoutMs ? timeoutMs : 1) * 1000;
+}
+
+uint64_t IQS5XX_Simulator::reportPeriodUs(uint64_t atUs) const {
+  // Without manual control the device drops to the idle report rate once
+  // no finger has been seen for the active mode timeout
+  bool manual = (_mem[IQS5XX_REG_SYS_CFG0] & IQS5XX_SYS_CFG0_MANUAL_CONTROL) != 0;
+  uint64_t activeTimeoutUs = (uint64_t)_mem[IQS5XX_REG_ACTIVE_TIMEOUT] * 1000000;
+  bool active = manual || (atUs - _lastTouchUs) < activeTimeoutUs;
+  uint16_t rateMs = reg16(active ? IQS5XX_REG_ACTIVE_REPORT_RATE : IQS5XX_REG_IDLE_REPORT_RATE);
+  return (uint64_t)rateMs * 1000;
+}
+
+void IQS5XX_Simulator::openWindow(uint64_t atUs) {
+  _state = WINDOW;
+  _forceWindow = false;
+  _reportedFingers = _fingers;
+  _lastActivityUs = atUs;
+  _windows++;
+  host::setPin(_readyPin, LOW);
+}
+
+void IQS5XX_Simulator::closeWindow(uint64_t atUs) {
+  host::setPin(_readyPin, HIGH);
+  _state = SENSING;
+  // The next cycle starts once the report period has elapsed, but never
+  // before the window has closed
+  uint64_t next = _cycleStartUs + reportPeriodUs(atUs);
+  _cycleStartUs = (next > atUs) ? next : atUs;
+}
+
+void IQS5XX_Simulator::sample(uint64_t atUs) {
+  // Fill the finger slots with the strokes active at this time, in
+  // touch-down order
+  uint8_t fingers = 0;
+  int8_t slot0Stroke = -1;
+  for (uint8_t i = 0; i < _strokeCount && fingers < IQS5XX_MAX_FINGERS; i++) {
+    const IQS5XX_Stroke &stroke = _strokes[i];
+    if (atUs < stroke.startUs || atUs >= stroke.endUs) {
+      continue;
+    }
+    uint64_t span = stroke.endUs - stroke.startUs;
+    uint64_t t = atUs - stroke.startUs;
+    int32_t x = stroke.x0 + (int32_t)(((int64_t)stroke.x1 - stroke.x0) * (int64_t)t / (int64_t)span);
+    int32_t y = stroke.y0 + (int32_t)(((int64_t)stroke.y1 - stroke.y0) * (int64_t)t / (int64_t)span);
+    x += noise();
+    y += noise();
+    x = (x < 0) ? 0 : (x > 0xFFFF) ? 0xFFFF : x;
+    y = (y < 0) ? 0 : (y > 0xFFFF) ? 0xFFFF : y;
+
+    uint16_t base = IQS5XX_REG_TOUCH_X + fingers * IQS5XX_FINGER_STRIDE;
+    setReg16(base + IQS5XX_FINGER_X, (uint16_t)x);
+    setReg16(base + IQS5XX_FINGER_Y, (uint16_t)y);
+    setReg16(base + IQS5XX_FINGER_STRENGTH, stroke.strength);
+    _mem[base + IQS5XX_FINGER_AREA] = stroke.area;
+
+    if (fingers == 0) {
+      slot0Stroke = (int8_t)i;
+      // Relative movement of finger 1 since the previous report
+      if (_lastStrokeInSlot0 == slot0Stroke) {
+        setReg16(IQS5XX_REG_REL_X, (uint16_t)(int16_t)(x - _lastX0));
+        setReg16(IQS5XX_REG_REL_Y, (uint16_t)(int16_t)(y - _lastY0));
+      } else {
+        setReg16(IQS5XX_REG_REL_X, 0);
+        setReg16(IQS5XX_REG_REL_Y, 0);
+      }
+      _lastX0 = (uint16_t)x;
+      _lastY0 = (uint16_t)y;
+    }
+    fingers++;
+  }
+
+  // Unused slots read back as zero
+  for (uint8_t slot = fingers; slot < IQS5XX_MAX_FINGERS; slot++) {
+    uint16_t base = IQS5XX_REG_TOUCH_X + slot * IQS5XX_FINGER_STRIDE;
+    memset(&_mem[base], 0, IQS5XX_FINGER_STRIDE);
+  }
+  if (fingers == 0) {
+    setReg16(IQS5XX_REG_REL_X, 0);
+    setReg16(IQS5XX_REG_REL_Y, 0);
+  } else {
+    _lastTouchUs = atUs;
+  }
+  _lastStrokeInSlot0 = slot0Stroke;
+  _fingers = fingers;
+  _mem[IQS5XX_REG_NUM_FINGERS] = fingers;
+
+  // Gesture events are only reported in a single window, and only the
+  // ones enabled in the gesture enable registers
+  uint8_t events0 = 0;
+  uint8_t events1 = 0;
+  for (uint8_t i = 0; i < _gestureCount; i++) {
+    Gesture &gesture = _gestures[i];
+    if (!gesture.reported && atUs >= gesture.atUs) {
+      events0 |= gesture.events0;
+      events1 |= gesture.events1;
+      gesture.reported = true;
+    }
+  }
+  _mem[IQS5XX_SYS_GESTURE_EVENTS_0] = events0 & _mem[IQS5XX_REG_SINGLE_FINGER_GESTURES];
+  _mem[IQS5XX_SYS_GESTURE_EVENTS_1] = events1 & _mem[IQS5XX_REG_MULTI_FINGER_GESTURES];
+}
+
+void IQS5XX_Simulator::onRegisterWrite(uint16_t reg, uint8_t value) {
+  switch (reg) {
+    case IQS5XX_REG_SYS_CNT0:
+      if (value & IQS5XX_SYS_CNT0_ACK_RESET) {
+        _mem[IQS5XX_REG_SYSTEM_INFO_0] &= ~IQS5XX_SYS_INFO0_SHOW_RESET;
+      }
+      if (value & IQS5XX_SYS_CNT0_RESEED) {
+        _reseeds++;
+      }
+      // Command bits clear once acted on; MODE_SELECT stays
+      _mem[reg] = value & ~IQS5XX_SYS_CNT0_COMMANDS;
+      break;
+    case IQS5XX_REG_SYS_CNT1:
+      if (value & IQS5XX_SYS_CNT1_RESET) {
+        powerOn();
+        return;
+      }
+      _mem[reg] = value;
+      if (value & IQS5XX_SYS_CNT1_SUSPEND) {
+        sleep();
+      }
+      break;
+    default:
+      // The XY data block is read-only
+      if (reg < IQS5XX_XY_BLOCK_START + IQS5XX_XY_BLOCK_LENGTH_FOR(IQS5XX_MAX_FINGERS)) {
+        return;
+      }
+      _mem[reg] = value;
+      break;
+  }
+}
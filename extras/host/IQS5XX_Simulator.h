@@ -0,0 +1,226 @@
+/**
+ * @file IQS5XX_Simulator.h
+ * @brief Register-level simulation of an IQS5XX-B000 trackpad for host builds
+ * @author lemio
+ *
+ * Implements the 16-bit addressed register map, the RDY communication
+ * window (conversion, window open until the I2C timeout expires or the
+ * end-communication-window command, report rate), clock stretching outside
+ * the window, event mode (cycles without an enabled event keep RDY high),
+ * the sleep NACK that wakeupDevice() handles, scripted finger
+ * trajectories with optional position noise and injected bus faults. Attach it to the host TwoWire and the virtual clock with
+ * attach().
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_SIMULATOR_H
+#define IQS5XX_SIMULATOR_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "IQS5XX_B000_Trackpad.h"
+
+// Maximum number of scripted strokes and gesture events
+#define IQS5XX_SIM_MAX_STROKES  32
+#define IQS5XX_SIM_MAX_GESTURES 16
+
+// Bus faults for IQS5XX_Simulator::injectFault()
+enum IQS5XX_SimFault {
+  IQS5XX_SIM_FAULT_NACK,        // Address not acknowledged (write or read phase)
+  IQS5XX_SIM_FAULT_SHORT_READ   // Read phase ends after half the requested bytes
+};
+
+/**
+ * @brief One finger contact moving linearly between two points
+ */
+struct IQS5XX_Stroke {
+  uint64_t startUs;   // Touch-down time
+  uint64_t endUs;     // Lift-off time
+  uint16_t x0, y0;    // Position at touch-down
+  uint16_t x1, y1;    // Position at lift-off
+  uint16_t strength;  // Reported touch strength
+  uint8_t area;       // Reported touch area
+};
+
+/**
+ * @class IQS5XX_Simulator
+ * @brief Simulated IQS5XX-B000 attached to the host I2C bus and clock
+ */
+class IQS5XX_Simulator : public host::Device, public host::I2CDevice {
+  public:
+    /**
+     * @brief Constructor
+     * @param readyPin Pin driven as the RDY output
+     * @param address I2C address (default: IQS5XX_DEFAULT_ADDRESS)
+     * @param productNumber Value of the product number register (40 = IQS550)
+     */
+    IQS5XX_Simulator(uint8_t readyPin, uint8_t address = IQS5XX_DEFAULT_ADDRESS,
+                     uint16_t productNumber = 40);
+
+    /**
+     * @brief Attach to a bus and to the virtual clock, then power on
+     * @param wire Host TwoWire instance
+     */
+    void attach(TwoWire &wire);
+
+    /**
+     * @brief Restore power-on register defaults and restart the RDY cycle
+     *
+     * Sets SHOW_RESET in System Info 0 until it is acknowledged through
+     * System Control 0.
+     */
+    void powerOn();
+
+    /**
+     * @brief Enter low-power sleep; the next access is NACKed and wakes the device
+     */
+    void sleep();
+
+    /**
+     * @brief Add a scripted finger contact
+     * @param stroke Contact description
+     * @return true if added, false if the stroke table is full
+     */
+    bool addStroke(const IQS5XX_Stroke &stroke);
+
+    /**
+     * @brief Report gesture event bits in the first window at or after a time
+     * @param atUs Virtual time of the gesture
+     * @param events0 Bits for GESTURE_EVENTS_0
+     * @param events1 Bits for GESTURE_EVENTS_1
+     * @return true if scheduled, false if the gesture table is full
+     */
+    bool addGesture(uint64_t atUs, uint8_t events0, uint8_t events1);
+
+    /**
+     * @brief Add sensor noise to the reported finger positions
+     *
+     * Every sample adds uniformly distributed noise to x and y of each
+     * finger. The sequence is pseudo-random from the seed, so runs repeat
+     * exactly.
+     * @param amplitude Largest deviation in counts, 0 = off (default)
+     * @param seed Noise generator seed (0 is replaced by 1)
+     */
+    void setNoise(uint16_t amplitude, uint32_t seed = 1);
+
+    /**
+     * @brief Remove all scripted strokes and gestures
+     */
+    void clearScript();
+
+    /**
+     * @brief Make the next bus phases fail
+     *
+     * A NACK fault hits the next write or read phase, a short read the next
+     * read phase. Faults do not change the device state: a NACKed write is
+     * not applied and a short read still advances the address pointer.
+     * @param fault Kind of fault
+     * @param count Number of phases to fail
+     */
+    void injectFault(IQS5XX_SimFault fault, uint8_t count = 1);
+
+    /**
+     * @brief Number of injected faults that hit a transaction
+     */
+    uint32_t faultsInjected() const { return _faultsHit; }
+
+    /**
+     * @brief Set the time spent sensing before each communication window
+     * @param us Conversion time in microseconds
+     */
+    void setConversionTimeUs(uint32_t us) { _conversionUs = us; }
+
+    uint8_t reg8(uint16_t reg) const { return _mem[reg]; }
+    uint16_t reg16(uint16_t reg) const { return (_mem[reg] << 8) | _mem[(uint16_t)(reg + 1)]; }
+    void setReg8(uint16_t reg, uint8_t value) { _mem[reg] = value; }
+    void setReg16(uint16_t reg, uint16_t value);
+
+    /**
+     * @brief Number of communication windows opened since power on
+     */
+    uint32_t windowsOpened() const { return _windows; }
+
+    /**
+     * @brief Number of sensing cycles that did not open a window (event mode)
+     */
+    uint32_t cyclesSkipped() const { return _skipped; }
+
+    /**
+     * @brief Number of RESEED commands received (System Control 0) since power on
+     */
+    uint32_t reseeds() const { return _reseeds; }
+
+    /**
+     * @brief Whether the communication window is currently open (RDY low)
+     */
+    bool windowOpen() const { return _state == WINDOW; }
+
+    /**
+     * @brief Whether the device is asleep
+     */
+    bool asleep() const { return _state == SLEEP; }
+
+    // host::Device
+    void tick(uint64_t nowUs) override;
+
+    // host::I2CDevice
+    uint8_t i2cAddress() const override { return _address; }
+    uint64_t i2cReadyAt(uint64_t nowUs) override;
+    uint8_t i2cWrite(const uint8_t* data, size_t length, bool stop) override;
+    size_t i2cRead(uint8_t* data, size_t length, bool stop) override;
+
+  private:
+    enum State { SENSING, WINDOW, SLEEP };
+
+    uint8_t _readyPin;
+    uint8_t _address;
+    uint16_t _productNumber;
+    uint8_t _mem[0x10000];
+    uint16_t _pointer;
+
+    State _state;
+    uint32_t _conversionUs;
+    uint64_t _cycleStartUs;     // Start of the current sensing cycle
+    uint64_t _lastActivityUs;   // Window open or last bus access in the window
+    uint64_t _wakeAtUs;         // Earliest ACK after a sleep NACK
+    uint64_t _lastTouchUs;
+    uint32_t _windows;
+    uint32_t _skipped;
+    uint32_t _reseeds;
+    bool _forceWindow;          // Host access pending while in event mode
+    uint8_t _fingers;           // Fingers in the latest sample
+    uint8_t _reportedFingers;   // Fingers in the last opened window
+
+    IQS5XX_Stroke _strokes[IQS5XX_SIM_MAX_STROKES];
+    uint8_t _strokeCount;
+    int8_t _lastStrokeInSlot0;
+    uint16_t _lastX0, _lastY0;
+    uint16_t _noiseAmplitude;
+    uint32_t _noiseState;       // xorshift32
+
+    struct Gesture {
+      uint64_t atUs;
+      uint8_t events0;
+      uint8_t events1;
+      bool reported;
+    };
+    Gesture _gestures[IQS5XX_SIM_MAX_GESTURES];
+    uint8_t _gestureCount;
+
+    IQS5XX_SimFault _fault;
+    uint8_t _faultCount;
+    uint32_t _faultsHit;
+
+    uint64_t windowOpensAt() const { return _cycleStartUs + _conversionUs; }
+    uint64_t windowClosesAt() const;
+    uint64_t reportPeriodUs(uint64_t atUs) const;
+    int32_t noise();
+    void openWindow(uint64_t atUs);
+    void closeWindow(uint64_t atUs);
+    void sample(uint64_t atUs);
+    bool eventPending() const;
+    void onRegisterWrite(uint16_t reg, uint8_t value);
+};
+
+#endif // IQS5XX_SIMULATOR_H
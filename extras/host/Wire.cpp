@@ -0,0 +1,166 @@
+/**
+ * @file Wire.cpp
+ * @brief Host TwoWire routing transactions to simulated devices
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire() {
+  _deviceCount = 0;
+  _clockHz = 100000;
+  _advanceClock = true;
+  _txAddress = 0;
+  _txLength = 0;
+  _txActive = false;
+  _rxLength = 0;
+  _rxIndex = 0;
+  resetStats();
+}
+
+void TwoWire::begin() {
+}
+
+void TwoWire::begin(int sda, int scl) {
+  (void)sda;
+  (void)scl;
+}
+
+void TwoWire::end() {
+}
+
+void TwoWire::setClock(uint32_t clockHz) {
+  _clockHz = clockHz;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _txAddress = address;
+  _txLength = 0;
+  _txActive = true;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (!_txActive || _txLength >= BUFFER_LENGTH) {
+    return 0;
+  }
+  _txBuffer[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+  size_t n = 0;
+  while (n < length && write(data[n])) {
+    n++;
+  }
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop) {
+  _txActive = false;
+  host::I2CDevice* device = findDevice(_txAddress);
+  if (device == nullptr) {
+    account(0, sendStop != 0);
+    _stats.nacks++;
+    return 2;
+  }
+
+  uint64_t readyAtUs = device->i2cReadyAt(host::nowUs());
+  if (_advanceClock) {
+    host::advanceToUs(readyAtUs);
+  }
+  uint8_t status = device->i2cWrite(_txBuffer, _txLength, sendStop != 0);
+  account(status == 0 ? _txLength : 0, sendStop != 0);
+  if (status == 0) {
+    _stats.bytesWritten += _txLength;
+  } else {
+    _stats.nacks++;
+  }
+  return status;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+  _rxLength = 0;
+  _rxIndex = 0;
+  if (quantity > BUFFER_LENGTH) {
+    quantity = BUFFER_LENGTH;
+  }
+
+  host::I2CDevice* device = findDevice(address);
+  if (device == nullptr) {
+    account(0, sendStop != 0);
+    _stats.nacks++;
+    return 0;
+  }
+
+  uint64_t readyAtUs = device->i2cReadyAt(host::nowUs());
+  if (_advanceClock) {
+    host::advanceToUs(readyAtUs);
+  }
+  _rxLength = device->i2cRead(_rxBuffer, quantity, sendStop != 0);
+  account(_rxLength, sendStop != 0);
+  if (_rxLength == 0) {
+    _stats.nacks++;
+  }
+  _stats.bytesRead += _rxLength;
+  return (uint8_t)_rxLength;
+}
+
+int TwoWire::available() {
+  return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read() {
+  if (_rxIndex >= _rxLength) {
+    return -1;
+  }
+  return _rxBuffer[_rxIndex++];
+}
+
+int TwoWire::peek() {
+  if (_rxIndex >= _rxLength) {
+    return -1;
+  }
+  return _rxBuffer[_rxIndex];
+}
+
+void TwoWire::attachDevice(host::I2CDevice* device) {
+  if (_deviceCount < MAX_DEVICES) {
+    _devices[_deviceCount++] = device;
+  }
+}
+
+void TwoWire::detachDevices() {
+  _deviceCount = 0;
+}
+
+void TwoWire::resetStats() {
+  _stats.transactions = 0;
+  _stats.bytesWritten = 0;
+  _stats.bytesRead = 0;
+  _stats.nacks = 0;
+  _stats.bits = 0;
+}
+
+host::I2CDevice* TwoWire::findDevice(uint8_t address) {
+  for (uint8_t i = 0; i < _deviceCount; i++) {
+    if (_devices[i]->i2cAddress() == address) {
+      return _devices[i];
+    }
+  }
+  return nullptr;
+}
+
+void TwoWire::account(size_t bytes, bool stop) {
+  // START + address byte with ACK + data bytes with ACK (+ STOP)
+  uint64_t bits = 1 + 9 + 9 * (uint64_t)bytes + (stop ? 1 : 0);
+  _stats.transactions++;
+  _stats.bits += bits;
+  if (!_advanceClock) {
+    return;
+  }
+  host::advanceUs((uint64_t)(host::wireTimeUs(bits, _clockHz) + 0.5));
+}
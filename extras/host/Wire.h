@@ -0,0 +1,167 @@
+/**
+ * @file Wire.h
+ * @brief Host (Linux) stand-in for the Arduino Wire library
+ * @author lemio
+ *
+ * TwoWire routes transactions to simulated I2C devices, advances the
+ * virtual clock by the modeled wire time and keeps bus counters so bus
+ * cost can be measured on a desktop.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 128
+
+namespace host {
+
+/**
+ * @class I2CDevice
+ * @brief Simulated I2C target attached to a TwoWire bus
+ */
+class I2CDevice {
+  public:
+    virtual ~I2CDevice() {}
+
+    /**
+     * @brief 7-bit address the device answers to
+     */
+    virtual uint8_t i2cAddress() const = 0;
+
+    /**
+     * @brief Earliest time the device will let a transaction complete
+     *
+     * Models clock stretching: the bus holds the host until this time.
+     * @param nowUs Current virtual time in microseconds
+     * @return Virtual time at which the transaction may proceed
+     */
+    virtual uint64_t i2cReadyAt(uint64_t nowUs) { return nowUs; }
+
+    /**
+     * @brief Handle a write transaction
+     * @param data Bytes written after the address byte
+     * @param length Number of bytes
+     * @param stop true if the transaction ends with a STOP condition
+     * @return Wire endTransmission() status (0 ok, 2 address NACK, 3 data NACK)
+     */
+    virtual uint8_t i2cWrite(const uint8_t* data, size_t length, bool stop) = 0;
+
+    /**
+     * @brief Handle a read transaction
+     * @param data Buffer to fill
+     * @param length Number of bytes requested
+     * @param stop true if the transaction ends with a STOP condition
+     * @return Number of bytes delivered, 0 if the address was NACKed
+     */
+    virtual size_t i2cRead(uint8_t* data, size_t length, bool stop) = 0;
+};
+
+/**
+ * @brief Bus counters kept by the host TwoWire
+ */
+struct WireStats {
+  uint32_t transactions;  // START conditions (write and read phases)
+  uint32_t bytesWritten;  // Data bytes written, excluding the address byte
+  uint32_t bytesRead;     // Data bytes read
+  uint32_t nacks;         // Transactions that were not acknowledged
+  uint64_t bits;          // Bits clocked on SCL including START/STOP/ACK
+};
+
+/**
+ * @brief Modeled time on the wire for a number of bus bits
+ * @param bits Bit count as accumulated in WireStats::bits
+ * @param clockHz SCL frequency
+ * @return Time in microseconds
+ */
+inline double wireTimeUs(uint64_t bits, uint32_t clockHz) {
+  return (double)bits * 1000000.0 / (double)clockHz;
+}
+
+} // namespace host
+
+/**
+ * @class TwoWire
+ * @brief Host implementation of the Arduino TwoWire interface
+ */
+class TwoWire {
+  public:
+    TwoWire();
+
+    void begin();
+    void begin(int sda, int scl);
+    void end();
+    void setClock(uint32_t clockHz);
+    uint32_t getClock() const { return _clockHz; }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(uint8_t sendStop = 1);
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = 1);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t)address, (uint8_t)quantity); }
+    int available();
+    int read();
+    int peek();
+
+    /**
+     * @brief Attach a simulated device to this bus
+     * @param device Device to attach (not owned)
+     */
+    void attachDevice(host::I2CDevice* device);
+
+    /**
+     * @brief Remove all simulated devices
+     */
+    void detachDevices();
+
+    /**
+     * @brief Bus counters accumulated since the last resetStats()
+     */
+    const host::WireStats& stats() const { return _stats; }
+
+    /**
+     * @brief Reset the bus counters
+     */
+    void resetStats();
+
+    /**
+     * @brief Whether transactions advance the virtual clock by their wire time
+     *
+     * Asynchronous bus models (HostAsyncI2C) account for the wire time
+     * themselves and run the transaction once it has elapsed.
+     * @param enable false to leave the clock alone (default: true)
+     */
+    void setAdvanceClock(bool enable) { _advanceClock = enable; }
+
+  private:
+    static const uint8_t MAX_DEVICES = 4;
+
+    host::I2CDevice* _devices[MAX_DEVICES];
+    uint8_t _deviceCount;
+    uint32_t _clockHz;
+    bool _advanceClock;
+
+    uint8_t _txAddress;
+    uint8_t _txBuffer[BUFFER_LENGTH];
+    size_t _txLength;
+    bool _txActive;
+
+    uint8_t _rxBuffer[BUFFER_LENGTH];
+    size_t _rxLength;
+    size_t _rxIndex;
+
+    host::WireStats _stats;
+
+    host::I2CDevice* findDevice(uint8_t address);
+    void account(size_t bytes, bool stop);
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,532 @@
+/**
+ * @file bench.cpp
+ * @brief Bus-cost benchmark of the public IQS5XX_B000_Trackpad API
+ * @author lemio
+ *
+ * Runs every public API against the simulated IQS5XX-B000 and reports per
+ * call: I2C transactions (START conditions), bytes on the wire, modeled
+ * wire time at 100/400/1000 kHz, simulated elapsed time (including RDY
+ * waits and clock stretching) and host CPU time.
+ *
+ * Usage: bench [--json] [--iterations N]
+ * Output is CSV by default so results can be diffed across commits.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "IQS5XX_B000_Trackpad.h"
+#include "IQS5XX_ContactTracker.h"
+#include "IQS5XX_Filter.h"
+#include "IQS5XX_Gestures.h"
+#include "IQS5XX_Kinematics.h"
+#include "IQS5XX_Scroll.h"
+#include "IQS5XX_Simulator.h"
+#include "HostAsyncI2C.h"
+
+#define RDY_PIN 39
+
+namespace {
+
+struct Result {
+  const char* name;
+  uint32_t calls;
+  double transactions;
+  double bytes;
+  double wireUs100k;
+  double wireUs400k;
+  double wireUs1M;
+  double simUs;
+  double cpuNs;
+};
+
+/**
+ * @brief Simulated device and trackpad ready for a benchmark run
+ */
+struct Fixture {
+  IQS5XX_Simulator* device;
+  IQS5XX_B000_Trackpad* trackpad;
+
+  explicit Fixture(bool initialized = true, uint8_t fingers = 1) {
+    host::reset();
+    Wire.detachDevices();
+    Wire.setClock(400000);
+    device = new IQS5XX_Simulator(RDY_PIN);
+    device->attach(Wire);
+    // Fingers resting on the pad for the whole run
+    for (uint8_t i = 0; i < fingers; i++) {
+      device->addStroke({0, 3600000000ULL, (uint16_t)(100 + 150 * i), 400, (uint16_t)(100 + 150 * i), 400, 400, 20});
+    }
+    trackpad = new IQS5XX_B000_Trackpad(RDY_PIN);
+    if (initialized) {
+      trackpad->begin(Wire);
+      trackpad->increaseSpeed();
+    }
+  }
+
+  ~Fixture() {
+    trackpad->endInterruptMode();
+    delete trackpad;
+    delete device;
+    Wire.detachDevices();
+    host::reset();
+  }
+};
+
+// Rows in one run; measure() stops the run rather than write past the end
+const uint8_t MAX_RESULTS = 128;
+Result g_results[MAX_RESULTS];
+uint8_t g_resultCount = 0;
+uint32_t g_iterations = 100;
+
+// Production-style profile: report rates, timeouts, system configuration,
+// axis setup and gesture tuning (31 register bytes)
+constexpr IQS5XX_RegisterValue kProfileTable[] = {
+  IQS5XX_CONFIG16(IQS5XX_REG_ACTIVE_REPORT_RATE, 5),
+  IQS5XX_CONFIG16(IQS5XX_REG_IDLE_TOUCH_REPORT_RATE, 20),
+  IQS5XX_CONFIG16(IQS5XX_REG_IDLE_REPORT_RATE, 50),
+  IQS5XX_CONFIG16(0x0580, 120),                    // LP1 report rate
+  IQS5XX_CONFIG16(0x0582, 160),                    // LP2 report rate
+  IQS5XX_CONFIG8(IQS5XX_REG_ACTIVE_TIMEOUT, 2),
+  IQS5XX_CONFIG8(0x0585, 10),                      // Idle touch timeout
+  IQS5XX_CONFIG8(0x0586, 20),                      // Idle timeout
+  IQS5XX_CONFIG8(0x0587, 40),                      // LP1 timeout
+  IQS5XX_CONFIG8(0x0588, 8),                       // Reference update time
+  IQS5XX_CONFIG8(0x0589, 0),                       // Snap timeout
+  IQS5XX_CONFIG8(IQS5XX_REG_I2C_TIMEOUT, 5),
+  IQS5XX_CONFIG8(IQS5XX_REG_SYS_CFG0, IQS5XX_SYS_CFG0_MANUAL_CONTROL),
+  IQS5XX_CONFIG8(IQS5XX_REG_SYS_CFG1, IQS5XX_EVENT_TP | IQS5XX_EVENT_GESTURE),
+  IQS5XX_CONFIG8(0x0669, 0x00),                    // XY config 0
+  IQS5XX_CONFIG8(0x066A, 5),                       // Max multi-touches
+  IQS5XX_CONFIG16(0x066E, 1024),                   // X resolution
+  IQS5XX_CONFIG16(0x0670, 1024),                   // Y resolution
+  IQS5XX_CONFIG8(0x06B7, 0x3F),                    // Single finger gestures
+  IQS5XX_CONFIG8(0x06B8, 0x07),                    // Multi finger gestures
+  IQS5XX_CONFIG16(0x06B9, 150),                    // Tap time
+  IQS5XX_CONFIG16(0x06BB, 50),                     // Tap distance
+};
+constexpr auto kProfile = IQS5XX_makeConfigProfile(kProfileTable);
+static_assert(kProfile.size() == 31 && kProfile.burstCount() == 5, "profile should coalesce into 5 bursts");
+
+// Time spent in idleUntil() during the current measurement
+uint64_t g_idleSimUs = 0;
+int64_t g_idleCpuNs = 0;
+
+/**
+ * @brief Let simulated time pass until `ready` holds, without charging it to the API under test
+ * @param ready Condition polled every 10 us of simulated time
+ */
+template <typename Ready>
+void idleUntil(Ready ready) {
+  uint64_t simStart = host::nowUs();
+  auto cpuStart = std::chrono::steady_clock::now();
+  while (!ready()) {
+    delayMicroseconds(10);
+  }
+  g_idleCpuNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - cpuStart).count();
+  g_idleSimUs += host::nowUs() - simStart;
+}
+
+/**
+ * @brief Measure `call` over `iterations` invocations and record the averages
+ * @param name API name used in the report
+ * @param fixture Prepared fixture
+ * @param call Invoked once per iteration
+ * @param iterations Number of calls (defaults to the global iteration count)
+ */
+template <typename Call>
+void measure(const char* name, Fixture &fixture, Call call, uint32_t iterations = 0) {
+  if (iterations == 0) {
+    iterations = g_iterations;
+  }
+  (void)fixture;
+  if (g_resultCount >= MAX_RESULTS) {
+    fprintf(stderr, "%s: more than %u results, raise MAX_RESULTS\n", name, (unsigned)MAX_RESULTS);
+    exit(1);
+  }
+
+  Wire.resetStats();
+  g_idleSimUs = 0;
+  g_idleCpuNs = 0;
+  uint64_t simStart = host::nowUs();
+  auto cpuStart = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++) {
+    call();
+  }
+  auto cpuEnd = std::chrono::steady_clock::now();
+  uint64_t simEnd = host::nowUs();
+
+  const host::WireStats &stats = Wire.stats();
+  Result &r = g_results[g_resultCount++];
+  r.name = name;
+  r.calls = iterations;
+  r.transactions = (double)stats.transactions / iterations;
+  r.bytes = (double)(stats.bytesWritten + stats.bytesRead) / iterations;
+  r.wireUs100k = host::wireTimeUs(stats.bits, 100000) / iterations;
+  r.wireUs400k = host::wireTimeUs(stats.bits, 400000) / iterations;
+  r.wireUs1M = host::wireTimeUs(stats.bits, 1000000) / iterations;
+  r.simUs = (double)(simEnd - simStart - g_idleSimUs) / iterations;
+  r.cpuNs = (double)(std::chrono::duration_cast<std::chrono::nanoseconds>(cpuEnd - cpuStart).count() - g_idleCpuNs) / iterations;
+}
+
+void runAll() {
+  {
+    Fixture f(false);
+    measure("begin", f, [&]() { f.trackpad->begin(Wire); }, 1);
+  }
+  {
+    // Startup sequence of the BasicTouchDetectionESP32 example
+    Fixture f(false);
+    measure("begin+enableManualControl+increaseSpeed", f, [&]() {
+      f.trackpad->begin(Wire);
+      f.trackpad->enableManualControl();
+      f.trackpad->increaseSpeed();
+    }, 1);
+  }
+  {
+    // Startup to first frame: profile written register by register versus
+    // the coalesced bursts applied by begin()
+    Fixture f(false);
+    measure("startup_to_first_frame_individual", f, [&]() {
+      f.trackpad->begin(Wire);
+      for (const IQS5XX_RegisterValue &entry : kProfileTable) {
+        f.trackpad->writeRegister8_16bit(entry.reg, entry.value);
+      }
+      f.trackpad->update();
+    }, 1);
+  }
+  {
+    Fixture f(false);
+    measure("startup_to_first_frame_profile", f, [&]() {
+      f.trackpad->begin(Wire, kProfile.bursts());
+      f.trackpad->update();
+    }, 1);
+  }
+  {
+    // MCU restart with the trackpad still powered: warm start from the
+    // fingerprint of the previous begin(), and the fallback when the
+    // device reset in between
+    for (int deviceReset = 0; deviceReset <= 1; deviceReset++) {
+      Fixture f(false);
+      f.trackpad->begin(Wire, kProfile.bursts());
+      DeviceFingerprint fingerprint = f.trackpad->getFingerprint();
+      if (deviceReset) {
+        f.device->powerOn();
+      }
+      delete f.trackpad;
+      f.trackpad = new IQS5XX_B000_Trackpad(RDY_PIN);
+      f.trackpad->setWarmStart(fingerprint);
+      measure(deviceReset ? "startup_to_first_frame_warm_after_reset" : "startup_to_first_frame_warm", f, [&]() {
+        f.trackpad->begin(Wire, kProfile.bursts());
+        f.trackpad->update();
+      }, 1);
+    }
+  }
+  {
+    Fixture f(false);
+    f.device->sleep();
+    measure("begin_from_sleep", f, [&]() { f.trackpad->begin(Wire); }, 1);
+  }
+  {
+    Fixture f;
+    measure("isConnected", f, [&]() { f.trackpad->isConnected(); });
+    measure("getProductNumber", f, [&]() { f.trackpad->getProductNumber(); });
+    measure("getVersionInfo", f, [&]() { f.trackpad->getVersionInfo(); });
+    measure("getSystemFlags", f, [&]() { f.trackpad->getSystemFlags(); });
+    measure("needsReset", f, [&]() { f.trackpad->needsReset(); });
+    measure("tryReadRegister16", f, [&]() { f.trackpad->tryReadRegister16(IQS5XX_REG_PRODUCT_NUMBER); });
+    measure("tryReadRegister16_nack", f, [&]() {
+      f.device->injectFault(IQS5XX_SIM_FAULT_NACK);
+      f.trackpad->tryReadRegister16(IQS5XX_REG_PRODUCT_NUMBER);
+    });
+    measure("enableManualControl", f, [&]() { f.trackpad->enableManualControl(); });
+    measure("enableManualControl_cold", f, [&]() {
+      f.trackpad->invalidateShadow();
+      f.trackpad->enableManualControl();
+    });
+    measure("increaseSpeed", f, [&]() { f.trackpad->increaseSpeed(); });
+  }
+  {
+    Fixture f;
+    f.device->sleep();
+    measure("wakeupDevice", f, [&]() { f.trackpad->wakeupDevice(); }, 1);
+  }
+  {
+    // Frame acquisition: every call waits for a new window (RDY HIGH, then
+    // LOW again), so sim_us is the achieved frame period
+    Fixture f;
+    TouchData touchData;
+    measure("readTouchData", f, [&]() { f.trackpad->readTouchData(touchData); });
+    measure("getTouchState", f, [&]() { f.trackpad->getTouchState(); });
+    measure("getTouchX", f, [&]() { f.trackpad->getTouchX(); });
+    measure("getTouchY", f, [&]() { f.trackpad->getTouchY(); });
+    measure("getTouchStrength", f, [&]() { f.trackpad->getTouchStrength(); });
+    measure("getTouchArea", f, [&]() { f.trackpad->getTouchArea(); });
+    measure("update", f, [&]() { f.trackpad->update(); });
+    measure("update+getTouchX+getTouchY", f, [&]() {
+      f.trackpad->update();
+      f.trackpad->getTouchX();
+      f.trackpad->getTouchY();
+    });
+  }
+  {
+    // Budgeted reads: RDY never asserts while the device sleeps
+    Fixture f;
+    TouchData touchData;
+    f.device->sleep();
+    measure("poll_not_ready", f, [&]() { f.trackpad->poll(touchData); });
+    measure("tryReadTouchData_1ms_timeout", f, [&]() { f.trackpad->tryReadTouchData(touchData, 1000); });
+  }
+  {
+    Fixture f;
+    MultiTouchFrame frame;
+    measure("readMultiTouch_1finger", f, [&]() { f.trackpad->readMultiTouch(frame); });
+  }
+  {
+    // Finger resting on the left edge (x == 0): one frame per touch, not
+    // retried as if the pad were empty
+    Fixture f(false, 0);
+    f.device->addStroke({0, 3600000000ULL, 0, 400, 0, 400, 400, 20});
+    f.trackpad->begin(Wire);
+    f.trackpad->increaseSpeed();
+    TouchData touchData;
+    measure("readTouchData_edge_touch", f, [&]() {
+      while (!f.trackpad->readTouchData(touchData)) {
+      }
+    });
+  }
+  {
+    Fixture f(true, 3);
+    MultiTouchFrame frame;
+    measure("readMultiTouch_3fingers", f, [&]() { f.trackpad->readMultiTouch(frame); });
+  }
+  {
+    Fixture f(true, 5);
+    MultiTouchFrame frame;
+    measure("readMultiTouch_5fingers", f, [&]() { f.trackpad->readMultiTouch(frame); });
+  }
+  {
+    Fixture f;
+    f.trackpad->beginInterruptMode();
+    TouchData touchData;
+    measure("service+popFrame", f, [&]() {
+      while (!f.trackpad->service()) {
+        delayMicroseconds(10);
+      }
+      f.trackpad->popFrame(touchData);
+    });
+  }
+  {
+    // Achieved frame period: RDY cycle stretched by the I2C timeout versus
+    // closing the window right after the burst read
+    for (int endWindow = 0; endWindow <= 1; endWindow++) {
+      Fixture f;
+      f.trackpad->setEndWindowAfterRead(endWindow != 0);
+      f.trackpad->beginInterruptMode();
+      TouchData touchData;
+      measure(endWindow ? "frame_period_end_window" : "frame_period_i2c_timeout", f, [&]() {
+        while (!f.trackpad->service()) {
+          delayMicroseconds(10);
+        }
+        f.trackpad->popFrame(touchData);
+      });
+    }
+  }
+  {
+    // Time the caller is held per frame: synchronous burst read versus
+    // submitting it to a backend and decoding after completion (waiting
+    // for RDY and for the transfer is excluded)
+    Fixture f;
+    TouchData touchData;
+    f.trackpad->setEndWindowAfterRead(true);
+    // A new window, not just RDY LOW: each window is read once
+    auto newWindow = [&]() { return f.trackpad->isReadyForData(); };
+    measure("poll_ready", f, [&]() {
+      idleUntil(newWindow);
+      f.trackpad->poll(touchData);
+    });
+
+    IQS5XX_WireI2C wireBackend(Wire);
+    f.trackpad->setI2CBackend(&wireBackend);
+    measure("pollAsync_ready_wire_backend", f, [&]() {
+      idleUntil(newWindow);
+      while (f.trackpad->pollAsync(touchData) != FRAME_READY) {
+        idleUntil(newWindow);
+      }
+    });
+
+    HostAsyncI2C asyncBackend(Wire);
+    f.trackpad->setI2CBackend(&asyncBackend);
+    measure("pollAsync_ready_async_backend", f, [&]() {
+      idleUntil(newWindow);
+      while (f.trackpad->pollAsync(touchData) != FRAME_READY) {
+        idleUntil([&]() { return !asyncBackend.busy() && newWindow(); });
+      }
+    });
+    // The last end-window write may still be in flight
+    idleUntil([&]() { return f.trackpad->setI2CBackend(nullptr); });
+  }
+  {
+    // 10 s trace with the finger down 20% of the time: streaming every
+    // report versus event mode (trackpad + gesture events)
+    for (int eventMode = 0; eventMode <= 1; eventMode++) {
+      Fixture f(true, 0);
+      for (uint32_t t = 1000000; t < 10000000; t += 5000000) {
+        f.device->addStroke({t, t + 1000000, 100, 300, 900, 700, 400, 20});
+      }
+      if (eventMode) {
+        f.trackpad->setEventMode(IQS5XX_EVENT_TP | IQS5XX_EVENT_GESTURE);
+      }
+      f.trackpad->beginInterruptMode();
+      TouchData touchData;
+      uint64_t end = host::nowUs() + 10000000;
+      measure(eventMode ? "duty_cycle_20pct_event_mode" : "duty_cycle_20pct_streaming", f, [&]() {
+        while (host::nowUs() < end) {
+          f.trackpad->service();
+          while (f.trackpad->popFrame(touchData)) {
+          }
+          delayMicroseconds(100);
+        }
+      }, 1);
+    }
+  }
+  {
+    Fixture f;
+    measure("softReset", f, [&]() { f.trackpad->softReset(); }, 1);
+  }
+  {
+    // Tracking cost only (no bus): five fingers moving, and every 16th
+    // frame the first finger lifts so the others shift down a slot
+    Fixture f(false, 0);
+    MultiTouchFrame frames[64];
+    memset(frames, 0, sizeof(frames));
+    for (uint8_t n = 0; n < 64; n++) {
+      uint8_t lifted = (n % 16 == 15) ? 1 : 0;
+      frames[n].numFingers = IQS5XX_MAX_FINGERS - lifted;
+      for (uint8_t i = lifted; i < IQS5XX_MAX_FINGERS; i++) {
+        frames[n].x[i - lifted] = 100 + 180 * i + 3 * n;
+        frames[n].y[i - lifted] = 300 + 2 * n;
+        frames[n].strength[i - lifted] = 400;
+      }
+    }
+    IQS5XX_ContactTracker tracker;
+    uint32_t n = 0;
+    uint32_t ids = 0;
+    measure("ContactTracker::update_5_fingers", f, [&]() {
+      ids += tracker.update(frames[n++ & 63]).contacts[0].id;
+    }, g_iterations * 100);
+
+    // Tracking plus velocity/acceleration estimates, 5 ms apart
+    IQS5XX_Kinematics kinematics;
+    uint32_t timestampUs = 0;
+    measure("ContactTracker+Kinematics::update_5_fingers", f, [&]() {
+      const MultiTouchFrame &frame = frames[n++ & 63];
+      timestampUs += 5000;
+      ids += kinematics.update(tracker.update(frame), frame, timestampUs).motion[0].vx;
+    }, g_iterations * 100);
+
+    // Tracking plus coordinate filtering, 5 ms apart
+    const OneEuroParams oneEuro = IQS5XX_ONE_EURO_DEFAULT;
+    const AlphaBetaParams alphaBeta = IQS5XX_ALPHA_BETA_DEFAULT;
+    IQS5XX_ContactFilter filter;
+    filter.setOneEuro(oneEuro);
+    measure("ContactTracker+OneEuro::update_5_fingers", f, [&]() {
+      timestampUs += 5000;
+      ids += filter.update(tracker.update(frames[n++ & 63]), timestampUs).contacts[0].x;
+    }, g_iterations * 100);
+    filter.setAlphaBeta(alphaBeta);
+    measure("ContactTracker+AlphaBeta::update_5_fingers", f, [&]() {
+      timestampUs += 5000;
+      ids += filter.update(tracker.update(frames[n++ & 63]), timestampUs).contacts[0].x;
+    }, g_iterations * 100);
+
+    // Tracking plus gesture recognition (the lifts re-take the baseline)
+    IQS5XX_GestureEngine engine;
+    GestureEvent event;
+    measure("ContactTracker+GestureEngine::update_5_fingers", f, [&]() {
+      timestampUs += 5000;
+      ids += engine.update(tracker.update(frames[n++ & 63]), timestampUs, event);
+    }, g_iterations * 100);
+
+    // One coasting output tick: decay, remainders and detents
+    IQS5XX_InertialScroll scroll;
+    ContactFrame pair = {};
+    MotionFrame pairMotion = {};
+    pair.count = pair.active = 2;
+    pairMotion.count = 2;
+    for (uint8_t i = 0; i < 2; i++) {
+      pair.contacts[i].id = pairMotion.motion[i].id = i + 1;
+      pair.contacts[i].x = 500 + 300 * i;
+      pairMotion.motion[i].samples = 4;
+      pairMotion.motion[i].vy = 3000 << IQS5XX_VELOCITY_SHIFT;
+    }
+    uint32_t scrollUs = 0;
+    measure("InertialScroll::service_tick", f, [&]() {
+      if (!scroll.coasting()) {
+        // Fling again: two fingers down, then both lifted
+        scroll.update(pair, pairMotion, scrollUs);
+        pair.active = 0;
+        scroll.update(pair, pairMotion, scrollUs);
+        pair.active = 2;
+      }
+      scrollUs += scroll.config().outputPeriodUs;
+      ids += scroll.service(scrollUs);
+    }, g_iterations * 100);
+    (void)ids;
+  }
+}
+
+void printCsv() {
+  printf("api,calls,transactions,bytes,wire_us_100k,wire_us_400k,wire_us_1m,sim_us,cpu_ns\n");
+  for (uint8_t i = 0; i < g_resultCount; i++) {
+    const Result &r = g_results[i];
+    printf("%s,%u,%.2f,%.2f,%.1f,%.1f,%.1f,%.1f,%.0f\n", r.name, (unsigned)r.calls,
+           r.transactions, r.bytes, r.wireUs100k, r.wireUs400k, r.wireUs1M, r.simUs, r.cpuNs);
+  }
+}
+
+void printJson() {
+  printf("[\n");
+  for (uint8_t i = 0; i < g_resultCount; i++) {
+    const Result &r = g_results[i];
+    printf("  {\"api\": \"%s\", \"calls\": %u, \"transactions\": %.2f, \"bytes\": %.2f, "
+           "\"wire_us_100k\": %.1f, \"wire_us_400k\": %.1f, \"wire_us_1m\": %.1f, "
+           "\"sim_us\": %.1f, \"cpu_ns\": %.0f}%s\n",
+           r.name, (unsigned)r.calls, r.transactions, r.bytes, r.wireUs100k, r.wireUs400k,
+           r.wireUs1M, r.simUs, r.cpuNs, (i + 1 < g_resultCount) ? "," : "");
+  }
+  printf("]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bool json = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      g_iterations = (uint32_t)atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--json] [--iterations N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (g_iterations == 0) {
+    g_iterations = 1;
+  }
+
+  runAll();
+  if (json) {
+    printJson();
+  } else {
+    printCsv();
+  }
+  return 0;
+}
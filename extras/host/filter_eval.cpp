@@ -0,0 +1,179 @@
+/**
+ * @file filter_eval.cpp
+ * @brief Jitter and latency of the contact filters on a noisy simulated stroke
+ * @author lemio
+ *
+ * Records one finger from the simulator twice, with and without position
+ * noise: resting, moving at 2000 counts/s, resting again. The noisy frames
+ * are replayed through each filter and compared with the clean ones:
+ *
+ *   rest_jitter     RMS error while resting, counts
+ *   motion_jitter   RMS error around the mean lag while moving, counts
+ *   lag_ms          mean error while moving divided by the speed
+ *   overshoot       largest excursion past the stop position, counts
+ *
+ * Prints CSV and exits with 1 if a filter does not reduce the jitter at rest.
+ *
+ * Usage: filter_eval [--noise N]
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "IQS5XX_B000_Trackpad.h"
+#include "IQS5XX_ContactTracker.h"
+#include "IQS5XX_Filter.h"
+#include "IQS5XX_Simulator.h"
+
+#define RDY_PIN 39
+
+namespace {
+
+// Stroke timing relative to the first touch, microseconds
+const uint32_t MOVE_START_US = 500000;
+const uint32_t MOVE_END_US = 900000;
+const uint32_t LIFT_US = 1200000;
+const uint16_t START_X = 1000;
+const uint16_t STOP_X = 1800;
+const uint16_t Y = 600;
+const int32_t SPEED = 2000;   // counts/s
+
+const uint16_t MAX_FRAMES = 256;
+
+struct Recording {
+  uint16_t count;
+  uint32_t timestampUs[MAX_FRAMES];   // Since the first touch
+  ContactFrame contacts[MAX_FRAMES];
+};
+
+Recording g_clean;
+Recording g_noisy;
+
+/**
+ * @brief Record the scripted stroke, one tracked frame per report
+ */
+bool record(Recording &recording, uint16_t noise) {
+  host::reset();
+  Wire.detachDevices();
+  Wire.setClock(400000);
+  IQS5XX_Simulator device(RDY_PIN);
+  device.attach(Wire);
+  device.setNoise(noise, 12345);
+  IQS5XX_B000_Trackpad trackpad(RDY_PIN);
+  if (!trackpad.begin(Wire)) {
+    return false;
+  }
+  trackpad.increaseSpeed();
+  trackpad.setEndWindowAfterRead(true);
+
+  uint64_t t0 = host::nowUs() + 10000;
+  device.addStroke({t0, t0 + MOVE_START_US, START_X, Y, START_X, Y, 400, 20});
+  device.addStroke({t0 + MOVE_START_US, t0 + MOVE_END_US, START_X, Y, STOP_X, Y, 400, 20});
+  device.addStroke({t0 + MOVE_END_US, t0 + LIFT_US, STOP_X, Y, STOP_X, Y, 400, 20});
+
+  IQS5XX_ContactTracker tracker;
+  recording.count = 0;
+  while (host::nowUs() < t0 + LIFT_US + 50000 && recording.count < MAX_FRAMES) {
+    MultiTouchFrame frame;
+    if (trackpad.tryReadMultiTouch(frame, 20000) != FRAME_READY) {
+      continue;
+    }
+    const ContactFrame &contacts = tracker.update(frame);
+    if (contacts.count == 0) {
+      continue;
+    }
+    recording.timestampUs[recording.count] = (uint32_t)(host::nowUs() - t0);
+    recording.contacts[recording.count++] = contacts;
+  }
+  trackpad.endInterruptMode();
+  Wire.detachDevices();
+  return true;
+}
+
+struct Metrics {
+  double restJitter;
+  double motionJitter;
+  double lagMs;
+  double overshoot;
+};
+
+Metrics evaluate(IQS5XX_ContactFilter &filter) {
+  double restSum = 0, moveSum = 0, moveSquares = 0, overshoot = 0;
+  uint32_t restCount = 0, moveCount = 0;
+  uint16_t frames = (g_clean.count < g_noisy.count) ? g_clean.count : g_noisy.count;
+  for (uint16_t n = 0; n < frames; n++) {
+    const ContactFrame &out = filter.update(g_noisy.contacts[n], g_noisy.timestampUs[n]);
+    const ContactFrame &clean = g_clean.contacts[n];
+    if (out.active == 0 || clean.active == 0) {
+      continue;
+    }
+    double ex = (double)clean.contacts[0].x - out.contacts[0].x;
+    double ey = (double)clean.contacts[0].y - out.contacts[0].y;
+    uint32_t t = g_noisy.timestampUs[n];
+    if (t > 100000 && t < MOVE_START_US) {
+      restSum += ex * ex + ey * ey;
+      restCount++;
+    } else if (t > MOVE_START_US + 100000 && t < MOVE_END_US) {
+      moveSum += ex;
+      moveSquares += ex * ex + ey * ey;
+      moveCount++;
+    } else if (t > MOVE_END_US && (double)out.contacts[0].x - STOP_X > overshoot) {
+      overshoot = (double)out.contacts[0].x - STOP_X;
+    }
+  }
+
+  Metrics metrics;
+  double meanLag = moveCount ? moveSum / moveCount : 0;
+  metrics.restJitter = restCount ? sqrt(restSum / restCount) : 0;
+  double variance = moveCount ? moveSquares / moveCount - meanLag * meanLag : 0;
+  metrics.motionJitter = (variance > 0) ? sqrt(variance) : 0;
+  metrics.lagMs = meanLag * 1000.0 / SPEED;
+  metrics.overshoot = overshoot;
+  return metrics;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint16_t noise = 8;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc) {
+      noise = (uint16_t)atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--noise N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (!record(g_clean, 0) || !record(g_noisy, noise)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+
+  const OneEuroParams oneEuro = IQS5XX_ONE_EURO_DEFAULT;
+  const AlphaBetaParams alphaBeta = IQS5XX_ALPHA_BETA_DEFAULT;
+  IQS5XX_ContactFilter filters[3];
+  filters[1].setOneEuro(oneEuro);
+  filters[2].setAlphaBeta(alphaBeta);
+  const char* names[3] = {"none", "one_euro", "alpha_beta"};
+
+  printf("filter,rest_jitter,motion_jitter,lag_ms,overshoot\n");
+  bool passed = true;
+  double rawJitter = 0;
+  for (uint8_t i = 0; i < 3; i++) {
+    Metrics m = evaluate(filters[i]);
+    printf("%s,%.2f,%.2f,%.1f,%.0f\n", names[i], m.restJitter, m.motionJitter, m.lagMs, m.overshoot);
+    if (i == 0) {
+      rawJitter = m.restJitter;
+    } else if (noise > 0 && m.restJitter >= rawJitter) {
+      passed = false;
+    }
+  }
+  fprintf(stderr, "%u frames, noise +/-%u counts\n", (unsigned)g_noisy.count, (unsigned)noise);
+  return passed ? 0 : 1;
+}
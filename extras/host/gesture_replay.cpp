@@ -0,0 +1,249 @@
+/**
+ * @file gesture_replay.cpp
+ * @brief Replays a recorded touch trace through the gesture engine
+ * @author lemio
+ *
+ * Reads frames in the CSV format of stream_decode (one frame per line,
+ * e.g. recorded from a real pad with IQS5XX_TouchStream), runs them through
+ * IQS5XX_ContactTracker and IQS5XX_GestureEngine and prints one line per
+ * gesture:
+ *
+ *   timestamp_us,gesture,phase,direction,fingers,dx,dy,scale_q8,angle,duration_us
+ *
+ * The engine is deterministic, so the output of a trace can be diffed
+ * against a stored expectation (make gestures).
+ *
+ * With --record the tool instead scripts a set of gestures on the
+ * simulator (device gestures off, a little position noise) and writes the
+ * trace to stdout; traces/gestures.csv was made this way.
+ *
+ * Usage: gesture_replay [--size WIDTHxHEIGHT] [file]
+ *        gesture_replay --record
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "IQS5XX_B000_Trackpad.h"
+#include "IQS5XX_ContactTracker.h"
+#include "IQS5XX_Gestures.h"
+#include "IQS5XX_Simulator.h"
+
+#define RDY_PIN 39
+
+namespace {
+
+// Pad size of the recorded trace, for edge swipes
+const uint16_t PAD_WIDTH = 2048;
+const uint16_t PAD_HEIGHT = 1536;
+
+const char* gestureName(GestureType type) {
+  switch (type) {
+    case GESTURE_NONE: return "none";
+    case GESTURE_TAP: return "tap";
+    case GESTURE_HOLD: return "hold";
+    case GESTURE_SWIPE: return "swipe";
+    case GESTURE_EDGE_SWIPE: return "edge_swipe";
+    case GESTURE_PINCH: return "pinch";
+    case GESTURE_ROTATE: return "rotate";
+  }
+  return "?";
+}
+
+const char* phaseName(GesturePhase phase) {
+  switch (phase) {
+    case GESTURE_BEGIN: return "begin";
+    case GESTURE_UPDATE: return "update";
+    case GESTURE_END: return "end";
+  }
+  return "?";
+}
+
+const char* directionName(GestureDirection direction) {
+  switch (direction) {
+    case DIRECTION_NONE: return "-";
+    case DIRECTION_X_PLUS: return "x+";
+    case DIRECTION_X_MINUS: return "x-";
+    case DIRECTION_Y_PLUS: return "y+";
+    case DIRECTION_Y_MINUS: return "y-";
+  }
+  return "?";
+}
+
+// Adds a stroke of two fingers turning around (cx, cy), in segments of 15 degrees
+void addRotation(IQS5XX_Simulator &device, uint64_t startUs, uint16_t cx, uint16_t cy, uint16_t radius) {
+  // cos/sin of 0, 15, 30, 45, 60 degrees, << 10
+  const int32_t COS[] = {1024, 989, 887, 724, 512};
+  const int32_t SIN[] = {0, 265, 512, 724, 887};
+  for (uint8_t k = 0; k < 4; k++) {
+    uint64_t from = startUs + k * 100000ULL;
+    int32_t x0 = (COS[k] * radius) >> 10, y0 = (SIN[k] * radius) >> 10;
+    int32_t x1 = (COS[k + 1] * radius) >> 10, y1 = (SIN[k + 1] * radius) >> 10;
+    device.addStroke({from, from + 100000, (uint16_t)(cx - x0), (uint16_t)(cy - y0),
+                      (uint16_t)(cx - x1), (uint16_t)(cy - y1), 400, 20});
+    device.addStroke({from, from + 100000, (uint16_t)(cx + x0), (uint16_t)(cy + y0),
+                      (uint16_t)(cx + x1), (uint16_t)(cy + y1), 380, 18});
+  }
+}
+
+/**
+ * @brief Script the gesture set on the simulator and print the trace
+ */
+int record() {
+  IQS5XX_Simulator device(RDY_PIN);
+  device.attach(Wire);
+  device.setNoise(2, 2024);
+  IQS5XX_B000_Trackpad trackpad(RDY_PIN);
+  if (!trackpad.begin(Wire)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  trackpad.increaseSpeed();
+  trackpad.setDeviceGestures(0, 0);
+  trackpad.setEndWindowAfterRead(true);
+
+  uint64_t t = host::nowUs() + 20000;
+  const uint64_t MS = 1000;
+  // One- and two-finger taps
+  device.addStroke({t, t + 80 * MS, 1000, 800, 1000, 800, 400, 20});
+  device.addStroke({t + 300 * MS, t + 390 * MS, 900, 800, 900, 800, 400, 20});
+  device.addStroke({t + 310 * MS, t + 390 * MS, 1200, 800, 1200, 800, 380, 18});
+  // Hold
+  device.addStroke({t + 600 * MS, t + 1300 * MS, 1000, 800, 1000, 800, 400, 20});
+  // One-finger swipe to +x, three-finger swipe to -y
+  device.addStroke({t + 1500 * MS, t + 1800 * MS, 500, 800, 1300, 800, 400, 20});
+  device.addStroke({t + 2000 * MS, t + 2300 * MS, 800, 1200, 800, 600, 400, 20});
+  device.addStroke({t + 2010 * MS, t + 2300 * MS, 1000, 1200, 1000, 600, 390, 19});
+  device.addStroke({t + 2020 * MS, t + 2300 * MS, 1200, 1200, 1200, 600, 380, 18});
+  // Swipe in from the left edge
+  device.addStroke({t + 2500 * MS, t + 2800 * MS, 20, 700, 700, 700, 400, 20});
+  // Pinch out
+  device.addStroke({t + 3000 * MS, t + 3400 * MS, 900, 800, 600, 800, 400, 20});
+  device.addStroke({t + 3000 * MS, t + 3400 * MS, 1100, 800, 1400, 800, 380, 18});
+  // Rotation by 60 degrees
+  addRotation(device, t + 3600 * MS, 1000, 800, 200);
+  // Two-finger swipe to -x
+  device.addStroke({t + 4300 * MS, t + 4600 * MS, 1400, 700, 700, 700, 400, 20});
+  device.addStroke({t + 4300 * MS, t + 4600 * MS, 1400, 1000, 700, 1000, 380, 18});
+
+  uint16_t sequence = 0;
+  uint8_t previousFingers = 0;
+  while (host::nowUs() < t + 4800 * MS) {
+    MultiTouchFrame frame;
+    if (trackpad.tryReadMultiTouch(frame, 20000) != FRAME_READY) {
+      continue;
+    }
+    // Idle frames carry nothing but the lift-off
+    if (frame.numFingers == 0 && previousFingers == 0) {
+      continue;
+    }
+    previousFingers = frame.numFingers;
+    printf("0,%u,%lu,%u,%u,%u", sequence++, (unsigned long)host::nowUs(),
+           frame.numFingers, frame.gestureEvents0, frame.gestureEvents1);
+    for (uint8_t i = 0; i < frame.numFingers && i < IQS5XX_MAX_FINGERS; i++) {
+      printf(",%u,%u,%u,%u", frame.x[i], frame.y[i], frame.strength[i], frame.area[i]);
+    }
+    printf("\n");
+  }
+  return 0;
+}
+
+/**
+ * @brief Parse one stream_decode line into a frame
+ */
+bool parseFrame(char* line, MultiTouchFrame &frame, uint32_t &timestampUs) {
+  unsigned long fields[6 + 4 * IQS5XX_MAX_FINGERS];
+  uint8_t count = 0;
+  char* cursor = line;
+  while (count < sizeof(fields) / sizeof(fields[0])) {
+    char* end;
+    fields[count] = strtoul(cursor, &end, 10);
+    if (end == cursor) {
+      break;
+    }
+    count++;
+    if (*end != ',') {
+      break;
+    }
+    cursor = end + 1;
+  }
+  if (count < 6 || (count - 6) % 4 != 0) {
+    return false;
+  }
+
+  memset(&frame, 0, sizeof(frame));
+  timestampUs = fields[2];
+  uint8_t slots = (count - 6) / 4;
+  frame.numFingers = (fields[3] < slots) ? fields[3] : slots;
+  frame.gestureEvents0 = fields[4];
+  frame.gestureEvents1 = fields[5];
+  for (uint8_t i = 0; i < slots; i++) {
+    frame.x[i] = fields[6 + 4 * i];
+    frame.y[i] = fields[7 + 4 * i];
+    frame.strength[i] = fields[8 + 4 * i];
+    frame.area[i] = fields[9 + 4 * i];
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  unsigned width = PAD_WIDTH, height = PAD_HEIGHT;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--record") == 0) {
+      return record();
+    } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc &&
+               sscanf(argv[i + 1], "%ux%u", &width, &height) == 2) {
+      i++;
+    } else if (path == nullptr && argv[i][0] != '-') {
+      path = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [--size WIDTHxHEIGHT] [file]\n       %s --record\n", argv[0], argv[0]);
+      return 2;
+    }
+  }
+
+  FILE* in = (path != nullptr) ? fopen(path, "r") : stdin;
+  if (in == nullptr) {
+    perror(path);
+    return 1;
+  }
+
+  IQS5XX_ContactTracker tracker;
+  IQS5XX_GestureEngine engine;
+  GestureConfig config = engine.config();
+  config.width = width;
+  config.height = height;
+  engine.setConfig(config);
+
+  char line[256];
+  unsigned long frames = 0, skipped = 0, gestures = 0;
+  while (fgets(line, sizeof(line), in) != nullptr) {
+    MultiTouchFrame frame;
+    uint32_t timestampUs;
+    if (!parseFrame(line, frame, timestampUs)) {
+      skipped++;
+      continue;
+    }
+    frames++;
+    GestureEvent event;
+    if (engine.update(tracker.update(frame), timestampUs, event)) {
+      gestures++;
+      printf("%lu,%s,%s,%s,%u,%d,%d,%u,%d,%lu\n", (unsigned long)timestampUs, gestureName(event.type),
+             phaseName(event.phase), directionName(event.direction), event.fingers, event.dx, event.dy,
+             event.scaleQ8, event.angle, (unsigned long)event.durationUs);
+    }
+  }
+  if (in != stdin) {
+    fclose(in);
+  }
+  fprintf(stderr, "%lu frames, %lu gestures, %lu lines skipped\n", frames, gestures, skipped);
+  return 0;
+}
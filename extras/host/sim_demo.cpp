@@ -0,0 +1,734 @@
+/**
+ * @file sim_demo.cpp
+ * @brief Runs the library against the simulated IQS5XX-B000
+ * @author lemio
+ *
+ * Scripts a one-finger swipe followed by a two-finger drag and prints the
+ * frames in the same CSV format as the BasicTouchDetectionESP32 example,
+ * followed by the bus cost of the run. Finally injects bus faults and an
+ * edge touch and checks that the library tells them apart, then checks
+ * that fast poll() and pollAsync() loops read every communication window
+ * once, that contact IDs survive fingers changing slots, that velocity
+ * estimates match scripted strokes, that host-side gestures replace the
+ * device's, that a two-finger fling coasts and decays, that stream packets
+ * carry the time a frame was read, that softReset() restarts the device,
+ * that begin() keeps the power mode a profile selects and that a destroyed
+ * trackpad releases the RDY interrupt; the exit code is non-zero if a
+ * check fails.
+ *
+ * With --stream the frames are written to stdout as binary stream packets
+ * (IQS5XX_TouchStream) and all text goes to stderr:
+ *
+ *   ./build/sim_demo --stream | ./build/stream_decode
+ *
+ * --stream-delta does the same with delta compression (a keyframe every 32
+ * frames).
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "HostAsyncI2C.h"
+#include "IQS5XX_B000_Trackpad.h"
+#include "IQS5XX_ContactTracker.h"
+#include "IQS5XX_Gestures.h"
+#include "IQS5XX_Kinematics.h"
+#include "IQS5XX_Scroll.h"
+#include "IQS5XX_Simulator.h"
+#include "IQS5XX_TouchStream.h"
+
+#define RDY_PIN 39
+
+// make INSTRUMENTATION=1 runs the demo on an instrumented trackpad
+#ifndef IQS5XX_INSTRUMENTATION
+#define IQS5XX_INSTRUMENTATION 0
+#endif
+
+namespace {
+
+#if IQS5XX_INSTRUMENTATION
+typedef IQS5XX_InstrumentedTrackpad Trackpad;
+#else
+typedef IQS5XX_B000_Trackpad Trackpad;
+#endif
+
+// The null stats policy takes no room in the trackpad
+static_assert(sizeof(IQS5XX_B000_Trackpad) + sizeof(IQS5XX_StatsRecorder) <= sizeof(IQS5XX_InstrumentedTrackpad),
+              "an uninstrumented trackpad must not hold a stats recorder");
+
+// Text output; stderr when stdout carries the binary stream
+FILE* g_text = stdout;
+
+const char* statusName(RegisterStatus status) {
+  switch (status) {
+    case REGISTER_OK: return "ok";
+    case REGISTER_NO_BUS: return "no bus";
+    case REGISTER_NACK: return "nack";
+    case REGISTER_SHORT_READ: return "short read";
+  }
+  return "?";
+}
+
+bool check(const char* name, bool passed) {
+  fprintf(g_text, "  %-44s %s\n", name, passed ? "ok" : "FAILED");
+  return passed;
+}
+
+bool near(int32_t value, int32_t expected, int32_t tolerance) {
+  return value >= expected - tolerance && value <= expected + tolerance;
+}
+
+/**
+ * @brief Bus faults versus genuine zero values and edge touches
+ * @return true if every check passed
+ */
+bool runFaultScenarios(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "fault injection:\n");
+
+  // A register that really reads 0 versus a NACKed read of it
+  trackpad.invalidateShadow();
+  RegisterResult<uint8_t> zero = trackpad.tryReadRegister8(IQS5XX_REG_SYS_CFG1);
+  passed &= check("SYS_CFG1 reads 0", zero.ok() && zero.value == 0);
+  trackpad.invalidateShadow();
+  device.injectFault(IQS5XX_SIM_FAULT_NACK);
+  RegisterResult<uint8_t> nack = trackpad.tryReadRegister8(IQS5XX_REG_SYS_CFG1);
+  fprintf(g_text, "  SYS_CFG1 with NACK: status %s\n", statusName(nack.status));
+  passed &= check("NACK reported as NACK", nack.status == REGISTER_NACK);
+  device.injectFault(IQS5XX_SIM_FAULT_SHORT_READ);
+  RegisterResult<uint16_t> product = trackpad.tryGetProductNumber();
+  passed &= check("short product number read reported", product.status == REGISTER_SHORT_READ);
+
+  // A failed read must not turn into a write that clears System Config 0
+  trackpad.invalidateShadow();
+  device.setReg8(IQS5XX_REG_SYS_CFG0, 0x05);
+  device.injectFault(IQS5XX_SIM_FAULT_NACK);
+  bool enabled = trackpad.enableManualControl();
+  passed &= check("enableManualControl fails on NACK", !enabled && device.reg8(IQS5XX_REG_SYS_CFG0) == 0x05);
+  passed &= check("enableManualControl keeps other bits",
+                  trackpad.enableManualControl() && device.reg8(IQS5XX_REG_SYS_CFG0) == 0x85);
+
+  // A finger on the left edge reports x == 0 and is still a touch
+  device.clearScript();
+  uint64_t now = host::nowUs();
+  device.addStroke({now, now + 100000, 0, 400, 0, 400, 400, 20});
+  delay(15);
+  TouchData touchData;
+  bool touched = trackpad.readTouchData(touchData);
+  fprintf(g_text, "  edge frame: x=%u y=%u fingers=%u\n", touchData.x, touchData.y, touchData.numFingers);
+  passed &= check("edge touch at x=0 reported", touched && touchData.x == 0 && touchData.state == SINGLE_TOUCH);
+
+  // A frame read that fails is a bus error, not a lift-off
+  device.injectFault(IQS5XX_SIM_FAULT_SHORT_READ);
+  passed &= check("short frame read is a bus error",
+                  trackpad.tryReadTouchData(touchData, 20000) == FRAME_BUS_ERROR);
+  passed &= check("next frame reads normally", trackpad.tryReadTouchData(touchData, 20000) == FRAME_READY &&
+                                                  touchData.state == SINGLE_TOUCH);
+  passed &= check("every injected fault hit", device.faultsInjected() == 4);
+
+  // Command bits always reach the device; MODE_SELECT stays in the cache
+  trackpad.invalidateShadow();
+  const uint8_t mode = 0x01;
+  uint32_t reseeds = device.reseeds();
+  trackpad.writeRegister8_16bit(IQS5XX_REG_SYS_CNT0, mode | IQS5XX_SYS_CNT0_RESEED);
+  trackpad.writeRegister8_16bit(IQS5XX_REG_SYS_CNT0, mode | IQS5XX_SYS_CNT0_RESEED);
+  passed &= check("repeated reseed reaches the device", device.reseeds() - reseeds == 2);
+  trackpad.resetBusStats();
+  RegisterResult<uint8_t> control = trackpad.tryReadRegister8(IQS5XX_REG_SYS_CNT0);
+  passed &= check("cached SYS_CNT0 keeps MODE_SELECT", control.ok() && control.value == mode &&
+                  trackpad.getBusStats().transactions == 0 && device.reg8(IQS5XX_REG_SYS_CNT0) == mode);
+  trackpad.writeRegister8_16bit(IQS5XX_REG_SYS_CNT0, 0);
+  return passed;
+}
+
+/**
+ * @brief A poll loop much faster than the report rate, default settings
+ * (the window stays open until the I2C timeout): every window is read once
+ * @return true if every check passed
+ */
+bool runWindowScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "communication windows:\n");
+
+  device.clearScript();
+  uint64_t now = host::nowUs();
+  device.addStroke({now, now + 200000, 100, 400, 900, 400, 400, 20});   // +4000 counts/s in x
+  delay(15);
+
+  uint32_t windows = device.windowsOpened();
+  uint32_t sequence = trackpad.getFrameSequence();
+  uint16_t frames = 0, duplicates = 0;
+  uint16_t lastX = 0;
+  while (host::nowUs() < now + 115000) {
+    TouchData touchData;
+    if (trackpad.poll(touchData) == FRAME_READY) {
+      // The finger moves 20 counts per report: an unchanged x is a re-read
+      duplicates += (frames > 0 && touchData.x == lastX);
+      lastX = touchData.x;
+      frames++;
+    }
+    delayMicroseconds(200);
+  }
+  windows = device.windowsOpened() - windows;
+
+  fprintf(g_text, "  %u frames, %u duplicates, %lu windows opened, sequence +%lu\n", frames, duplicates,
+          (unsigned long)windows, (unsigned long)(trackpad.getFrameSequence() - sequence));
+  passed &= check("no window read twice", frames > 0 && duplicates == 0);
+  passed &= check("one frame per window", near(frames, windows, 1));
+  passed &= check("frame sequence counts windows", trackpad.getFrameSequence() - sequence == frames);
+
+  // A fixed-rate task at the report rate only ever samples RDY LOW when the
+  // report period (10 ms) outlasts the I2C timeout (5 ms): the window it
+  // read counts as closed once the (cached) timeout has expired
+  trackpad.writeRegister8_16bit(IQS5XX_REG_I2C_TIMEOUT, 5);
+  trackpad.writeRegister16(IQS5XX_REG_ACTIVE_REPORT_RATE, 10);
+  now = host::nowUs();
+  device.addStroke({now, now + 300000, 100, 400, 900, 400, 400, 20});
+  delay(25);
+  // Line the polls up with the start of a window
+  TouchData first;
+  trackpad.tryReadTouchData(first, 20000);
+  trackpad.tryReadTouchData(first, 20000);
+  lastX = first.x;
+  windows = device.windowsOpened();
+  frames = duplicates = 0;
+  uint16_t highs = 0;
+  uint64_t next = host::nowUs();
+  for (uint8_t i = 0; i < 20; i++) {
+    next += 10000;
+    delayMicroseconds((uint32_t)(next - host::nowUs()));
+    highs += (digitalRead(RDY_PIN) == HIGH);
+    TouchData touchData;
+    if (trackpad.poll(touchData) == FRAME_READY) {
+      duplicates += (touchData.x == lastX);
+      lastX = touchData.x;
+      frames++;
+    }
+  }
+  windows = device.windowsOpened() - windows;
+  trackpad.writeRegister16(IQS5XX_REG_ACTIVE_REPORT_RATE, 5);
+  fprintf(g_text, "  report-rate poll: %u frames, %u duplicates, %lu windows opened, RDY HIGH %u times\n",
+          frames, duplicates, (unsigned long)windows, highs);
+  passed &= check("report-rate poll keeps reading", highs == 0 && frames >= 18 && duplicates == 0);
+  passed &= check("report-rate poll reads every window", near(frames, windows, 1));
+  return passed;
+}
+
+// Wire backend that can be told to reject submissions, like a busy driver
+class RejectingI2C : public IQS5XX_WireI2C {
+  public:
+    explicit RejectingI2C(TwoWire &wire) : IQS5XX_WireI2C(wire), rejects(0) {}
+    bool submit(IQS5XX_I2CTransfer &transfer) override {
+      if (rejects > 0) {
+        rejects--;
+        return false;
+      }
+      return IQS5XX_WireI2C::submit(transfer);
+    }
+    uint8_t rejects;
+};
+
+/**
+ * @brief pollAsync(): a fast loop reads every window once, and a rejected
+ * submission in interrupt mode keeps the frame pending
+ * @return true if every check passed
+ */
+bool runAsyncWindowScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "non-blocking windows:\n");
+
+  device.clearScript();
+  uint64_t now = host::nowUs();
+  device.addStroke({now, now + 200000, 100, 400, 900, 400, 400, 20});
+  delay(15);
+
+  HostAsyncI2C backend(Wire);
+  trackpad.setI2CBackend(&backend);
+  uint32_t windows = device.windowsOpened();
+  uint16_t frames = 0, duplicates = 0;
+  uint16_t lastX = 0;
+  while (host::nowUs() < now + 115000) {
+    TouchData touchData;
+    if (trackpad.pollAsync(touchData) == FRAME_READY) {
+      duplicates += (frames > 0 && touchData.x == lastX);
+      lastX = touchData.x;
+      frames++;
+    }
+    delayMicroseconds(200);
+  }
+  windows = device.windowsOpened() - windows;
+  fprintf(g_text, "  %u frames, %u duplicates, %lu windows opened\n", frames, duplicates, (unsigned long)windows);
+  passed &= check("pollAsync reads no window twice", frames > 0 && duplicates == 0);
+  passed &= check("pollAsync reads one frame per window", near(frames, windows, 1));
+
+  // The backend writes into the trackpad until its transfer completes
+  TouchData touchData;
+  uint64_t deadline = host::nowUs() + 20000;
+  while (!backend.busy() && host::nowUs() < deadline) {
+    trackpad.pollAsync(touchData);
+    delayMicroseconds(10);
+  }
+  RejectingI2C rejecting(Wire);
+  bool refused = backend.busy() && !trackpad.setI2CBackend(&rejecting);
+  delay(2);
+  passed &= check("backend switch waits for the transfer", refused && !backend.busy() &&
+                  trackpad.setI2CBackend(&rejecting));
+
+  trackpad.beginInterruptMode();
+  delay(10);   // A falling edge marks a frame as pending
+  rejecting.rejects = 1;
+  bool rejected = trackpad.pollAsync(touchData) == FRAME_BUS_ERROR;
+  bool retried = trackpad.pollAsync(touchData) == FRAME_READY;
+  trackpad.endInterruptMode();
+  trackpad.setI2CBackend(nullptr);
+  passed &= check("rejected submit keeps the frame pending", rejected && retried);
+  return passed;
+}
+
+/**
+ * @brief Contact IDs while fingers land and lift around each other
+ *
+ * Finger A lifts while B stays down, so B moves from slot 1 to slot 0;
+ * then C lands in slot 1.
+ * @return true if every check passed
+ */
+bool runTrackingScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "contact tracking:\n");
+
+  // Start from an empty pad, not from the edge touch above
+  device.clearScript();
+  MultiTouchFrame frame;
+  while (trackpad.tryReadMultiTouch(frame, 20000) != FRAME_READY || frame.numFingers != 0) {
+    delay(10);
+  }
+
+  uint64_t now = host::nowUs();
+  device.addStroke({now + 10000, now + 80000, 200, 300, 260, 300, 400, 20});    // A
+  device.addStroke({now + 10000, now + 200000, 700, 500, 640, 560, 380, 18});   // B
+  device.addStroke({now + 120000, now + 200000, 400, 800, 420, 780, 360, 16});  // C
+
+  IQS5XX_ContactTracker tracker;
+  uint8_t idA = IQS5XX_CONTACT_ID_NONE;
+  uint8_t idB = IQS5XX_CONTACT_ID_NONE;
+  uint8_t idC = IQS5XX_CONTACT_ID_NONE;
+  bool bKeptId = true;
+  bool bMovedSlot = false;
+  uint8_t liftsOfA = 0;
+  while (host::nowUs() < now + 250000) {
+    if (trackpad.tryReadMultiTouch(frame, 20000) != FRAME_READY) {
+      continue;
+    }
+    const ContactFrame &contacts = tracker.update(frame);
+    for (uint8_t i = 0; i < contacts.count; i++) {
+      const Contact &contact = contacts.contacts[i];
+      if (contact.phase == CONTACT_DOWN) {
+        // A and B land together (A in slot 0), C later
+        uint8_t &id = (idA == IQS5XX_CONTACT_ID_NONE && contact.slot == 0) ? idA :
+                      (idB == IQS5XX_CONTACT_ID_NONE) ? idB : idC;
+        id = contact.id;
+        fprintf(g_text, "  id %u down in slot %u at %u,%u\n", contact.id, contact.slot, contact.x, contact.y);
+      } else if (contact.phase == CONTACT_UP) {
+        fprintf(g_text, "  id %u up from slot %u\n", contact.id, contact.slot);
+        liftsOfA += (contact.id == idA);
+      } else if (contact.x >= 600) {
+        // Only B moves through x >= 600
+        bKeptId &= (contact.id == idB);
+        bMovedSlot |= (contact.slot == 0);
+      }
+    }
+    delay(10);
+  }
+
+  passed &= check("B keeps its ID after moving to slot 0", bKeptId && bMovedSlot);
+  passed &= check("A lifts exactly once", liftsOfA == 1);
+  passed &= check("C gets a new ID", idC != IQS5XX_CONTACT_ID_NONE && idC != idA && idC != idB);
+  passed &= check("all contacts lifted at the end", tracker.contacts().active == 0);
+
+  // The largest gate and penalty must not wrap the cost: a finger 150 counts
+  // away in its own slot beats one 380 counts away in another
+  IQS5XX_ContactTracker wide;
+  wide.setMaxJump(65535);
+  wide.setSlotPenalty(65535);
+  memset(&frame, 0, sizeof(frame));
+  frame.numFingers = 1;
+  uint8_t id = wide.update(frame).contacts[0].id;
+  frame.numFingers = 2;
+  frame.y[0] = 150;
+  frame.x[1] = 380;
+  wide.update(frame);
+  const Contact* kept = wide.find(id);
+  passed &= check("maximum slot penalty does not wrap", kept != nullptr && kept->slot == 0);
+  return passed;
+}
+
+/**
+ * @brief Velocity of two constant-speed strokes, one in slot 0 (device
+ * relative data) and one in slot 1 (absolute positions)
+ * @return true if every check passed
+ */
+bool runKinematicsScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "kinematics:\n");
+
+  device.clearScript();
+  uint64_t now = host::nowUs();
+  device.addStroke({now + 10000, now + 410000, 100, 500, 900, 500, 400, 20});   // +2000 counts/s in x
+  device.addStroke({now + 10000, now + 410000, 600, 800, 600, 200, 380, 18});   // -1500 counts/s in y
+
+  // REL_X/REL_Y cover one report: read every report, paced by RDY
+  trackpad.setEndWindowAfterRead(true);
+  IQS5XX_ContactTracker tracker;
+  IQS5XX_Kinematics kinematics;
+  int32_t midVx = 0, midVy = 0, midAx = 0, releaseVx = 0;
+  bool released = false;
+  while (host::nowUs() < now + 450000) {
+    MultiTouchFrame frame;
+    if (trackpad.tryReadMultiTouch(frame, 20000) != FRAME_READY) {
+      continue;
+    }
+    const ContactFrame &contacts = tracker.update(frame);
+    const MotionFrame &motion = kinematics.update(contacts, frame, micros());
+    for (uint8_t i = 0; i < contacts.count; i++) {
+      const Contact &contact = contacts.contacts[i];
+      const ContactMotion &m = motion.motion[i];
+      bool middle = host::nowUs() > now + 200000 && host::nowUs() < now + 220000;
+      if (middle && contact.slot == 0) {
+        midVx = m.vx >> IQS5XX_VELOCITY_SHIFT;
+        midAx = m.ax;
+      } else if (middle && contact.slot == 1) {
+        midVy = m.vy >> IQS5XX_VELOCITY_SHIFT;
+      } else if (contact.phase == CONTACT_UP && contact.slot == 0) {
+        releaseVx = m.vx >> IQS5XX_VELOCITY_SHIFT;
+        released = true;
+      }
+    }
+  }
+  trackpad.setEndWindowAfterRead(false);
+
+  fprintf(g_text, "  slot 0: vx %ld counts/s, ax %ld counts/s^2; slot 1: vy %ld counts/s; release vx %ld\n",
+          (long)midVx, (long)midAx, (long)midVy, (long)releaseVx);
+  passed &= check("slot 0 vx within 5% (relative data)", near(midVx, 2000, 100));
+  passed &= check("slot 1 vy within 5% (absolute positions)", near(midVy, -1500, 75));
+  passed &= check("constant speed, small acceleration", near(midAx, 0, 2000));
+  passed &= check("release velocity reported", released && near(releaseVx, 2000, 100));
+
+  // With five fingers down, a finger landing in the frame another lifts
+  // takes the freed track and has a velocity one frame later
+  IQS5XX_ContactTracker handTracker;
+  IQS5XX_Kinematics handKinematics;
+  MultiTouchFrame hand;
+  memset(&hand, 0, sizeof(hand));
+  hand.numFingers = IQS5XX_MAX_FINGERS;
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    hand.x[i] = 100 + i * 150;
+    hand.y[i] = 500;
+  }
+  handKinematics.update(handTracker.update(hand), hand, 0);
+  hand.y[IQS5XX_MAX_FINGERS - 1] = 1000;   // Beyond the gate: lift and land
+  const ContactFrame &landed = handTracker.update(hand);
+  handKinematics.update(landed, hand, 10000);
+  uint8_t newId = IQS5XX_CONTACT_ID_NONE;
+  for (uint8_t i = 0; i < landed.count; i++) {
+    if (landed.contacts[i].phase == CONTACT_DOWN) {
+      newId = landed.contacts[i].id;
+    }
+  }
+  hand.y[IQS5XX_MAX_FINGERS - 1] = 1010;
+  handKinematics.update(handTracker.update(hand), hand, 20000);
+  const ContactMotion* moved = handKinematics.find(newId);
+  passed &= check("touch-down in a full frame gets a track", moved != nullptr && moved->samples == 1 &&
+                  near(moved->vy >> IQS5XX_VELOCITY_SHIFT, 1000, 10));
+  return passed;
+}
+
+/**
+ * @brief Device gestures off, the same swipe recognized on the host
+ * @return true if every check passed
+ */
+bool runGestureScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "gestures:\n");
+
+  device.clearScript();
+  bool disabled = trackpad.setDeviceGestures(0, 0);
+  passed &= check("device gestures disabled", disabled &&
+                  device.reg8(IQS5XX_REG_SINGLE_FINGER_GESTURES) == 0 &&
+                  device.reg8(IQS5XX_REG_MULTI_FINGER_GESTURES) == 0);
+
+  uint64_t now = host::nowUs();
+  device.addStroke({now + 10000, now + 210000, 300, 500, 1100, 500, 400, 20});
+  device.addGesture(now + 210000, 0x08, 0);   // Swipe X+ as the device would flag it
+
+  IQS5XX_ContactTracker tracker;
+  IQS5XX_GestureEngine engine;
+  uint8_t deviceEvents = 0;
+  GestureEvent swipe = {};
+  while (host::nowUs() < now + 260000) {
+    MultiTouchFrame frame;
+    if (trackpad.tryReadMultiTouch(frame, 20000) != FRAME_READY) {
+      continue;
+    }
+    deviceEvents |= frame.gestureEvents0 | frame.gestureEvents1;
+    GestureEvent event;
+    if (engine.update(tracker.update(frame), micros(), event)) {
+      swipe = event;
+    }
+    delay(10);
+  }
+  trackpad.setDeviceGestures(IQS5XX_SINGLE_FINGER_GESTURES_ALL, IQS5XX_MULTI_FINGER_GESTURES_ALL);
+
+  fprintf(g_text, "  host gesture %u, direction %u, dx %d\n", swipe.type, swipe.direction, swipe.dx);
+  passed &= check("no gesture bits from the device", deviceEvents == 0);
+  passed &= check("host recognizes the swipe", swipe.type == GESTURE_SWIPE &&
+                  swipe.direction == DIRECTION_X_PLUS && near(swipe.dx, 800, 80));
+  return passed;
+}
+
+// Totals of the scroll events, collected by the callback
+struct ScrollTotals {
+  uint32_t events;
+  uint32_t offPeriod;           // Events not on the output period grid
+  uint32_t firstUs, lastUs;
+  int32_t dragY, momentumY, wheel;
+};
+
+void onScroll(const ScrollEvent &event, void* context) {
+  ScrollTotals &totals = *static_cast<ScrollTotals*>(context);
+  if (totals.events++ == 0) {
+    totals.firstUs = event.timestampUs;
+  } else if ((event.timestampUs - totals.firstUs) % 8000 != 0) {
+    totals.offPeriod++;
+  }
+  totals.lastUs = event.timestampUs;
+  (event.momentum ? totals.momentumY : totals.dragY) += event.dy;
+  totals.wheel += event.wheel;
+}
+
+/**
+ * @brief Two-finger fling: drag, release, coast at 125 Hz while the pad
+ * reports at 200 Hz; then a second fling caught by a tap
+ * @return true if every check passed
+ */
+bool runScrollScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "scroll:\n");
+
+  device.clearScript();
+  uint64_t now = host::nowUs();
+  // +1500 counts/s in y for 200 ms, then a second fling caught after 100 ms
+  device.addStroke({now + 10000, now + 210000, 700, 300, 700, 600, 400, 20});
+  device.addStroke({now + 10000, now + 210000, 1000, 300, 1000, 600, 380, 18});
+  device.addStroke({now + 2000000, now + 2200000, 700, 300, 700, 600, 400, 20});
+  device.addStroke({now + 2000000, now + 2200000, 1000, 300, 1000, 600, 380, 18});
+  device.addStroke({now + 2300000, now + 2350000, 900, 800, 900, 800, 400, 20});
+
+  trackpad.setEndWindowAfterRead(true);
+  IQS5XX_ContactTracker tracker;
+  IQS5XX_Kinematics kinematics;
+  IQS5XX_InertialScroll scroll;
+  ScrollConfig config = scroll.config();
+  config.outputPeriodUs = 8000;
+  scroll.setConfig(config);
+  ScrollTotals first = {}, second = {};
+  scroll.setCallback(onScroll, &first);
+  bool switched = false, stopped = false, caught = false;
+  while (host::nowUs() < now + 2600000) {
+    if (!switched && host::nowUs() > now + 1900000) {
+      // The first fling is over; count the second one separately
+      switched = true;
+      stopped = !scroll.coasting() && !scroll.dragging();
+      scroll.setCallback(onScroll, &second);
+    }
+    if (trackpad.isReadyForData()) {
+      MultiTouchFrame frame;
+      if (trackpad.tryReadMultiTouch(frame, 20000) == FRAME_READY) {
+        const ContactFrame &contacts = tracker.update(frame);
+        scroll.update(contacts, kinematics.update(contacts, frame, micros()), micros());
+      }
+    }
+    scroll.service(micros());
+    if (host::nowUs() > now + 2310000 && host::nowUs() < now + 2320000) {
+      caught = !scroll.coasting();
+    }
+    delayMicroseconds(500);
+  }
+  trackpad.setEndWindowAfterRead(false);
+
+  fprintf(g_text, "  %lu events over %lu ms: drag dy %ld, momentum dy %ld, wheel %ld\n",
+          (unsigned long)first.events, (unsigned long)((first.lastUs - first.firstUs) / 1000),
+          (long)first.dragY, (long)first.momentumY, (long)first.wheel);
+  passed &= check("events on the 8 ms output grid", first.events > 0 && first.offPeriod == 0);
+  // The first report comes up to 5 ms (7.5 counts) into the stroke
+  passed &= check("drag follows the fingers", near(first.dragY, 300, 15));
+  // Coasting covers about (release - minimum velocity) x time constant
+  passed &= check("momentum within 15% of v x tau", near(first.momentumY, 560, 84));
+  passed &= check("coasting decays and stops", stopped);
+  passed &= check("whole wheel detents", near(first.wheel * 64, first.dragY + first.momentumY, 63));
+  passed &= check("a new touch stops coasting", caught && second.momentumY < first.momentumY / 2);
+  return passed;
+}
+
+// Print that feeds its bytes straight into a stream decoder
+class DecodingPrint : public Print {
+  public:
+    DecodingPrint() : packets(0) {}
+    size_t write(uint8_t c) override {
+      packets += decoder.push(c);
+      return 1;
+    }
+    using Print::write;
+    IQS5XX_StreamDecoder decoder;
+    uint16_t packets;
+};
+
+/**
+ * @brief A frame sent late keeps the time it was read
+ * @return true if every check passed
+ */
+bool runStreamScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "stream timestamps:\n");
+
+  device.clearScript();
+  DecodingPrint link;
+  IQS5XX_TouchStream touchStream(link);
+  MultiTouchFrame frame;
+  bool read = trackpad.tryReadMultiTouch(frame, 20000) == FRAME_READY;
+  uint32_t readUs = micros();
+  delay(20);   // Queued behind other output
+  bool sent = touchStream.write(frame, readUs);
+  passed &= check("stream carries the read time", read && sent && link.packets == 1 &&
+                  link.decoder.frame().timestampUs == readUs);
+  return passed;
+}
+
+/**
+ * @brief softReset() through System Control 1, then a fresh begin()
+ * @return true if every check passed
+ */
+bool runResetScenario(IQS5XX_Simulator &device, Trackpad &trackpad) {
+  bool passed = true;
+  fprintf(g_text, "soft reset:\n");
+
+  device.clearScript();
+  bool reset = trackpad.softReset();
+  passed &= check("soft reset restarts the device", reset &&
+                  (device.reg8(IQS5XX_REG_SYSTEM_INFO_0) & IQS5XX_SYS_INFO0_SHOW_RESET) &&
+                  trackpad.needsReset());
+  passed &= check("begin() after the reset", trackpad.begin(Wire) && !trackpad.needsReset());
+
+  // Acknowledging the reset keeps a power mode set by the profile
+  static constexpr IQS5XX_RegisterValue kModeTable[] = {
+    IQS5XX_CONFIG8(IQS5XX_REG_SYS_CNT0, 0x02),
+  };
+  static constexpr auto kModeProfile = IQS5XX_makeConfigProfile(kModeTable);
+  trackpad.softReset();
+  bool begun = trackpad.begin(Wire, kModeProfile.bursts()) && !trackpad.needsReset();
+  trackpad.resetBusStats();
+  RegisterResult<uint8_t> control = trackpad.tryReadRegister8(IQS5XX_REG_SYS_CNT0);
+  passed &= check("profile MODE_SELECT survives begin()", begun &&
+                  (device.reg8(IQS5XX_REG_SYS_CNT0) & IQS5XX_SYS_CNT0_MODE_SELECT) == 0x02 &&
+                  control.ok() && control.value == 0x02 && trackpad.getBusStats().transactions == 0);
+  trackpad.writeRegister8_16bit(IQS5XX_REG_SYS_CNT0, 0);
+  return passed;
+}
+
+/**
+ * @brief A trackpad destroyed in interrupt mode releases the RDY handler
+ * @return true if every check passed
+ */
+bool runInterruptOwnerScenario() {
+  bool passed = true;
+  fprintf(g_text, "interrupt ownership:\n");
+
+  bool first = false;
+  {
+    IQS5XX_B000_Trackpad temporary(RDY_PIN);
+    temporary.begin(Wire);
+    first = temporary.beginInterruptMode();
+  }
+  IQS5XX_B000_Trackpad next(RDY_PIN);
+  bool second = next.begin(Wire) && next.beginInterruptMode();
+  passed &= check("destructor ends interrupt mode", first && second);
+  return passed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bool delta = (argc > 1 && strcmp(argv[1], "--stream-delta") == 0);
+  bool stream = delta || (argc > 1 && strcmp(argv[1], "--stream") == 0);
+  if (stream) {
+    g_text = stderr;
+  }
+  IQS5XX_TouchStream touchStream(Serial, 0, delta ? 32 : 0);
+  IQS5XX_Simulator device(RDY_PIN);
+  device.attach(Wire);
+  device.addStroke({20000, 120000, 100, 500, 900, 500, 400, 20});
+  device.addStroke({150000, 250000, 300, 200, 300, 700, 380, 18});
+  device.addStroke({160000, 250000, 600, 200, 600, 700, 360, 17});
+
+  Trackpad trackpad(RDY_PIN);
+  if (!trackpad.begin(Wire)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  trackpad.increaseSpeed();
+  trackpad.resetBusStats();
+
+  const StartupTiming &timing = trackpad.getStartupTiming();
+  fprintf(g_text, "begin(): probe %lu us, wake %lu us, identify %lu us, configure %lu us\n",
+          (unsigned long)timing.probeUs, (unsigned long)timing.wakeUs,
+          (unsigned long)timing.identifyUs, (unsigned long)timing.configureUs);
+
+  uint32_t frames = 0;
+  while (millis() < 300) {
+    MultiTouchFrame frame;
+    if (!trackpad.readMultiTouch(frame)) {
+      continue;
+    }
+    uint32_t readUs = micros();
+    frames++;
+    if (stream) {
+      touchStream.write(frame, readUs);
+    } else {
+      fprintf(g_text, "%lu ms", millis());
+      for (uint8_t i = 0; i < frame.numFingers; i++) {
+        fprintf(g_text, "  %u,%u,%u,%u", frame.x[i], frame.y[i], frame.strength[i], frame.area[i]);
+      }
+      fprintf(g_text, "\n");
+    }
+
+    // The window stays open until the I2C timeout expires; give the device
+    // time to close it and sense again, like the delay() in the example
+    delay(10);
+  }
+
+  fprintf(g_text, "first frame %lu us after begin()\n", (unsigned long)timing.firstReadyUs);
+#if IQS5XX_INSTRUMENTATION
+  if (!stream) {
+    trackpad.printStats(Serial);
+  }
+#endif
+  BusStats stats = trackpad.getBusStats();
+  fprintf(g_text, "%u frames, %u transactions, %u bytes written, %u bytes read\n",
+          (unsigned)frames, (unsigned)stats.transactions,
+          (unsigned)stats.bytesWritten, (unsigned)stats.bytesRead);
+
+  bool passed = runFaultScenarios(device, trackpad);
+  passed &= runWindowScenario(device, trackpad);
+  passed &= runAsyncWindowScenario(device, trackpad);
+  passed &= runTrackingScenario(device, trackpad);
+  passed &= runKinematicsScenario(device, trackpad);
+  passed &= runGestureScenario(device, trackpad);
+  passed &= runScrollScenario(device, trackpad);
+  passed &= runStreamScenario(device, trackpad);
+  passed &= runResetScenario(device, trackpad);
+  passed &= runInterruptOwnerScenario();
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file stream_decode.cpp
+ * @brief Decodes a binary touch stream (IQS5XX_Stream.h) into CSV
+ * @author lemio
+ *
+ * Reads packets from a file or stdin (a serial port device works too) and
+ * prints one CSV line per frame:
+ *
+ *   channel,sequence,timestamp_us,fingers,gesture0,gesture1[,x,y,strength,area]...
+ *
+ * Keyframe and delta packets from several pads can be mixed in one stream.
+ * A summary with the decoder counters and the average packet size goes to
+ * stderr.
+ *
+ * Usage: stream_decode [--quiet] [file]
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "IQS5XX_Stream.h"
+
+int main(int argc, char** argv) {
+  bool quiet = false;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quiet") == 0) {
+      quiet = true;
+    } else if (path == nullptr && argv[i][0] != '-') {
+      path = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [--quiet] [file]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  FILE* in = (path != nullptr) ? fopen(path, "rb") : stdin;
+  if (in == nullptr) {
+    perror(path);
+    return 1;
+  }
+
+  IQS5XX_StreamDecoder decoder;
+  unsigned long bytes = 0;
+  unsigned long frameBytes = 0;
+  unsigned long packetBytes = 0;
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    bytes++;
+    packetBytes++;
+    if (!decoder.push((uint8_t)c)) {
+      if (c == 0) {
+        packetBytes = 0;
+      }
+      continue;
+    }
+    frameBytes += packetBytes;
+    packetBytes = 0;
+    if (quiet) {
+      continue;
+    }
+
+    const IQS5XX_StreamFrame &frame = decoder.frame();
+    printf("%u,%u,%lu,%u,%u,%u", frame.channel, frame.sequence, (unsigned long)frame.timestampUs,
+           frame.numFingers, frame.gestureEvents0, frame.gestureEvents1);
+    for (uint8_t i = 0; i < frame.slots; i++) {
+      printf(",%u,%u,%u,%u", frame.x[i], frame.y[i], frame.strength[i], frame.area[i]);
+    }
+    printf("\n");
+  }
+  if (in != stdin) {
+    fclose(in);
+  }
+
+  const IQS5XX_StreamStats &stats = decoder.stats();
+  fprintf(stderr, "%lu bytes, %lu frames, %lu dropped, %lu crc errors, %lu framing errors, "
+          "%lu skipped deltas", bytes, (unsigned long)stats.frames,
+          (unsigned long)stats.droppedFrames, (unsigned long)stats.crcErrors,
+          (unsigned long)stats.framingErrors, (unsigned long)stats.skippedDeltas);
+  if (stats.frames > 0) {
+    fprintf(stderr, ", %.1f bytes/frame", (double)frameBytes / stats.frames);
+  }
+  fprintf(stderr, "\n");
+  return 0;
+}
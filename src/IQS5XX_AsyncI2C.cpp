@@ -0,0 +1,38 @@
+/**
+ * @file IQS5XX_AsyncI2C.cpp
+ * @brief Blocking Wire backend of the non-blocking I2C transfer interface
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_AsyncI2C.h"
+
+bool IQS5XX_WireI2C::submit(IQS5XX_I2CTransfer &transfer) {
+  if (transfer.txLength > IQS5XX_I2C_MAX_WRITE || (transfer.rxLength > 0 && transfer.rx == nullptr)) {
+    return false;
+  }
+  transfer.status = I2C_TRANSFER_BUSY;
+
+  if (transfer.txLength > 0) {
+    _wire->beginTransmission(transfer.address);
+    _wire->write(transfer.tx, transfer.txLength);
+    if (_wire->endTransmission() != 0) {
+      complete(transfer, false);
+      return true;
+    }
+  }
+
+  if (transfer.rxLength > 0) {
+    if (_wire->requestFrom(transfer.address, transfer.rxLength) != transfer.rxLength) {
+      complete(transfer, false);
+      return true;
+    }
+    for (uint8_t i = 0; i < transfer.rxLength; i++) {
+      transfer.rx[i] = _wire->read();
+    }
+  }
+
+  complete(transfer, true);
+  return true;
+}
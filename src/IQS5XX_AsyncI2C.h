@@ -0,0 +1,126 @@
+/**
+ * @file IQS5XX_AsyncI2C.h
+ * @brief Non-blocking I2C transfer interface with pluggable backends
+ * @author lemio
+ *
+ * A transfer (optional register address/data write followed by an optional
+ * read) is handed to a backend with submit(), which returns immediately.
+ * Completion is signalled through IQS5XX_I2CTransfer::status, which the
+ * loop can poll, and an optional callback. Backends:
+ *  - IQS5XX_WireI2C: blocking Wire fallback, completes inside submit()
+ *  - IQS5XX_EspIdfI2C (IQS5XX_EspIdfI2C.h): ESP-IDF asynchronous I2C master
+ *  - HostAsyncI2C (extras/host): simulated bus with modeled wire time
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_ASYNC_I2C_H
+#define IQS5XX_ASYNC_I2C_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Longest register address plus data written by one transfer
+#define IQS5XX_I2C_MAX_WRITE 4
+
+/**
+ * @brief Progress of an I2C transfer
+ */
+enum I2CTransferStatus {
+  I2C_TRANSFER_IDLE,   // Never submitted
+  I2C_TRANSFER_BUSY,   // Submitted, not yet finished
+  I2C_TRANSFER_DONE,   // Finished, read data valid
+  I2C_TRANSFER_ERROR   // NACK or bus error
+};
+
+struct IQS5XX_I2CTransfer;
+
+/**
+ * @brief Completion callback
+ *
+ * Backends that complete from an interrupt (ESP-IDF) call it in interrupt
+ * context, so keep it short (e.g. set a flag or notify a task).
+ */
+typedef void (*IQS5XX_I2CCallback)(IQS5XX_I2CTransfer &transfer, void* context);
+
+/**
+ * @brief One addressed I2C transfer: write txLength bytes, then read rxLength bytes
+ *
+ * The transfer and its rx buffer must stay valid until status leaves
+ * I2C_TRANSFER_BUSY.
+ */
+struct IQS5XX_I2CTransfer {
+  uint8_t address;                     // 7-bit device address
+  uint8_t tx[IQS5XX_I2C_MAX_WRITE];    // Register address (+ data)
+  uint8_t txLength;
+  uint8_t* rx;                         // Destination of the read phase
+  uint8_t rxLength;                    // 0 for a write-only transfer
+  volatile I2CTransferStatus status;
+  IQS5XX_I2CCallback callback;         // Optional, may be nullptr
+  void* context;                       // Passed to the callback
+};
+
+/**
+ * @class IQS5XX_I2CBackend
+ * @brief Executes transfers without making the caller wait for the bus
+ *
+ * Backends run one transfer at a time.
+ */
+class IQS5XX_I2CBackend {
+  public:
+    virtual ~IQS5XX_I2CBackend() {}
+
+    /**
+     * @brief Start a transfer and return without waiting for it
+     * @param transfer Transfer to run; status becomes I2C_TRANSFER_BUSY
+     * @return true if accepted, false if the backend is busy or the transfer is invalid
+     */
+    virtual bool submit(IQS5XX_I2CTransfer &transfer) = 0;
+
+    /**
+     * @brief Advance backends that complete from the loop (no-op otherwise)
+     */
+    virtual void poll() {}
+
+    /**
+     * @brief Whether a transfer is in flight
+     */
+    virtual bool busy() const = 0;
+
+  protected:
+    /**
+     * @brief Publish the result of a transfer and run its callback
+     * @param transfer Finished transfer
+     * @param ok true if every byte was acknowledged
+     */
+    static void complete(IQS5XX_I2CTransfer &transfer, bool ok) {
+      transfer.status = ok ? I2C_TRANSFER_DONE : I2C_TRANSFER_ERROR;
+      if (transfer.callback != nullptr) {
+        transfer.callback(transfer, transfer.context);
+      }
+    }
+};
+
+/**
+ * @class IQS5XX_WireI2C
+ * @brief Blocking fallback on top of TwoWire
+ *
+ * Runs the transfer inside submit(), so it works on every core but the
+ * caller still waits for the bus.
+ */
+class IQS5XX_WireI2C : public IQS5XX_I2CBackend {
+  public:
+    /**
+     * @brief Constructor
+     * @param wire Initialized TwoWire instance
+     */
+    explicit IQS5XX_WireI2C(TwoWire &wire) : _wire(&wire) {}
+
+    bool submit(IQS5XX_I2CTransfer &transfer) override;
+    bool busy() const override { return false; }
+
+  private:
+    TwoWire* _wire;
+};
+
+#endif // IQS5XX_ASYNC_I2C_H
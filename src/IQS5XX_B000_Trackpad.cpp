@@ -13,24 +13,75 @@
 
 #include "IQS5XX_B000_Trackpad.h"
 
-IQS5XX_B000_Trackpad::IQS5XX_B000_Trackpad(uint8_t readyPin, uint8_t address) {
+template <class StatsPolicy>
+IQS5XX_B000_TrackpadT<StatsPolicy>* IQS5XX_B000_TrackpadT<StatsPolicy>::_interruptInstance = nullptr;
+
+template <class StatsPolicy>
+IQS5XX_B000_TrackpadT<StatsPolicy>::IQS5XX_B000_TrackpadT(uint8_t readyPin, uint8_t address) {
   _readyPin = readyPin;
   pinMode(_readyPin, INPUT);
   _address = address;
   _wire = nullptr;
-  _lastTouchData = {0, 0, 0, 0, NO_TOUCH};
+  _lastTouchData = {0, 0, 0, 0, 0, NO_TOUCH};
+  _frameSequence = 0;
+  resetBusStats();
+  _framePending = false;
+  _windowConsumed = false;
+  _lastAccessUs = 0;
+  _interruptMode = false;
+  _expectedFingers = 1;
+  _endWindowAfterRead = false;
+  _lastNumFingers = 0;
+  _backend = nullptr;
+  _asyncState = ASYNC_IDLE;
+  _transfer.status = I2C_TRANSFER_IDLE;
+  invalidateShadow();
+  _startupTiming = {0, 0, 0, 0, 0, false};
+  _startupStartUs = 0;
+  _awaitFirstFrame = false;
+  _fingerprint = {0, 0, 0, false};
+  _warmStart = {0, 0, 0, false};
+}
+
+template <class StatsPolicy>
+IQS5XX_B000_TrackpadT<StatsPolicy>::~IQS5XX_B000_TrackpadT() {
+  // The interrupt handler must not keep a pointer to a destroyed instance
+  endInterruptMode();
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::begin(TwoWire &wire) {
+  IQS5XX_ConfigBursts noProfile = {nullptr, 0, nullptr};
+  return begin(wire, noProfile);
 }
 
-bool IQS5XX_B000_Trackpad::begin(TwoWire &wire) {
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::begin(TwoWire &wire, const IQS5XX_ConfigBursts &profile) {
+  _startupStartUs = micros();
+  _startupTiming = {0, 0, 0, 0, 0, false};
+  _awaitFirstFrame = false;
+  _fingerprint.valid = false;
+  
   _wire = &wire;
   _wire->begin();
+  invalidateShadow();
+  
+  // A fingerprint is only good for one begin()
+  uint16_t profileHash = hashProfile(profile);
+  DeviceFingerprint saved = _warmStart;
+  _warmStart.valid = false;
+  bool warm = saved.valid && saved.address == _address && saved.profileHash == profileHash;
   
-  // Initial delay to allow device to stabilize
-  delay(1);
+  // Initial delay to allow device to stabilize after power-up
+  if (!warm) {
+    delay(1);
+  }
   
   // Check if device responds at expected address
-  _wire->beginTransmission(_address);
+  startTransaction();
   uint8_t error = _wire->endTransmission();
+  countTransaction(0, 0, error == 0);
+  _startupTiming.probeUs = micros() - _startupStartUs;
   
   if (error == 0) {
     // Device found and already awake
@@ -43,112 +94,212 @@ bool IQS5XX_B000_Trackpad::begin(TwoWire &wire) {
     // No device found
     return false;
   }
+  _startupTiming.wakeUs = micros() - _startupStartUs;
+  
+  // Warm start: the device kept its configuration if it has not reset
+  // since the reset was acknowledged by the begin() that configured it
+  if (warm) {
+    uint8_t info;
+    if (readBytes16(IQS5XX_REG_SYSTEM_INFO_0, &info, 1) == REGISTER_OK && !(info & IQS5XX_SYS_INFO0_SHOW_RESET)) {
+      _startupTiming.identifyUs = micros() - _startupStartUs;
+      _startupTiming.configureUs = _startupTiming.identifyUs;
+      _startupTiming.warmStart = true;
+      _fingerprint = saved;
+      _awaitFirstFrame = true;
+      return true;
+    }
+    // The device reset since it was configured: full startup
+  }
   
   // Verify device by reading product number
-  uint16_t productNumber = getProductNumber();
-  if (productNumber == 0) {
+  RegisterResult<uint16_t> productNumber = tryGetProductNumber();
+  if (!productNumber.ok()) {
     return false;
   }
   
   // Check product ID (lower byte)
-  uint8_t productID = productNumber & 0xFF;
+  uint8_t productID = productNumber.value & 0xFF;
   if (productID != 40 && productID != 58 && productID != 52) {
     // Not a recognized IQS5XX device (40=IQS550, 58=IQS572, 52=IQS525)
     return false;
   }
+  _startupTiming.identifyUs = micros() - _startupStartUs;
+  
+  // Apply the configuration profile, if any
+  if (!applyConfig(profile)) {
+    return false;
+  }
   
   // Enable manual control mode
   if (!enableManualControl()) {
     return false;
   }
   
-  // Additional stabilization delay after configuration
-  delay(1);
+  // Acknowledge the power-on reset so later frames only report new resets
+  if (!acknowledgeReset()) {
+    return false;
+  }
+  _startupTiming.configureUs = micros() - _startupStartUs;
   
+  // No settling delay: the first frame read waits for RDY anyway
+  _fingerprint = {productNumber.value, profileHash, _address, true};
+  _awaitFirstFrame = true;
   return true;
 }
 
-bool IQS5XX_B000_Trackpad::isConnected() {
-  if (_wire == nullptr) {
-    return false;
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::setWarmStart(const DeviceFingerprint &fingerprint) {
+  _warmStart = fingerprint;
+}
+
+template <class StatsPolicy>
+DeviceFingerprint IQS5XX_B000_TrackpadT<StatsPolicy>::getFingerprint() const {
+  return _fingerprint;
+}
+
+template <class StatsPolicy>
+const StartupTiming& IQS5XX_B000_TrackpadT<StatsPolicy>::getStartupTiming() const {
+  return _startupTiming;
+}
+
+template <class StatsPolicy>
+uint16_t IQS5XX_B000_TrackpadT<StatsPolicy>::hashProfile(const IQS5XX_ConfigBursts &profile) {
+  uint16_t hash = 0x811C;
+  for (uint8_t i = 0; i < profile.count; i++) {
+    const IQS5XX_ConfigBurst &burst = profile.bursts[i];
+    uint8_t bytes[2] = {(uint8_t)(burst.reg >> 8), (uint8_t)(burst.reg & 0xFF)};
+    for (uint8_t j = 0; j < 2; j++) {
+      hash = (hash ^ bytes[j]) * 0x0193;
+    }
+    for (uint8_t j = 0; j < burst.length; j++) {
+      hash = (hash ^ profile.data[burst.offset + j]) * 0x0193;
+    }
   }
-  
-  _wire->beginTransmission(_address);
-  return (_wire->endTransmission() == 0);
+  return hash;
 }
 
-uint16_t IQS5XX_B000_Trackpad::getProductNumber() {
-  if (_wire == nullptr) {
-    return 0;
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::noteFrame() {
+  if (_awaitFirstFrame) {
+    _startupTiming.firstReadyUs = micros() - _startupStartUs;
+    _awaitFirstFrame = false;
   }
-  
-  _wire->beginTransmission(_address);
-  _wire->write((IQS5XX_REG_PRODUCT_NUMBER >> 8) & 0xFF); // High byte of address
-  _wire->write(IQS5XX_REG_PRODUCT_NUMBER & 0xFF);        // Low byte of address
-  
-  if (_wire->endTransmission() != 0) {
-    return 0;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::applyConfig(const IQS5XX_ConfigBursts &profile) {
+  for (uint8_t i = 0; i < profile.count; i++) {
+    const IQS5XX_ConfigBurst &burst = profile.bursts[i];
+    if (!writeBytes16(burst.reg, profile.data + burst.offset, burst.length)) {
+      return false;
+    }
   }
-  
-  if (_wire->requestFrom(_address, (uint8_t)2) != 2) {
-    return 0;
+  return true;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::isConnected() {
+  if (_wire == nullptr) {
+    return false;
   }
   
-  uint8_t productHigh = _wire->read();
-  uint8_t productLow = _wire->read();
-  
-  return (productHigh << 8) | productLow;
+  startTransaction();
+  bool ok = (_wire->endTransmission() == 0);
+  countTransaction(0, 0, ok);
+  return ok;
 }
 
-uint16_t IQS5XX_B000_Trackpad::getVersionInfo() {
-  return readRegister16(IQS5XX_REG_VERSION_INFO);
+template <class StatsPolicy>
+uint16_t IQS5XX_B000_TrackpadT<StatsPolicy>::getProductNumber() {
+  return tryGetProductNumber().value;
 }
 
-uint8_t IQS5XX_B000_Trackpad::getSystemFlags() {
-  return readRegister8(IQS5XX_REG_SYS_FLAGS);
+template <class StatsPolicy>
+RegisterResult<uint16_t> IQS5XX_B000_TrackpadT<StatsPolicy>::tryGetProductNumber() {
+  return tryReadRegister16(IQS5XX_REG_PRODUCT_NUMBER);
 }
 
-bool IQS5XX_B000_Trackpad::needsReset() {
-  uint8_t flags = getSystemFlags();
-  return (flags & IQS5XX_SYS_FLAG_RESET) != 0;
+template <class StatsPolicy>
+uint16_t IQS5XX_B000_TrackpadT<StatsPolicy>::getVersionInfo() {
+  return readRegister16(IQS5XX_REG_VERSION_INFO).value;
 }
 
-bool IQS5XX_B000_Trackpad::readTouchData(TouchData &touchData) {
-  // Wait for RDY pin to be LOW (device ready)
-  while(digitalRead(_readyPin) == HIGH) { 
-    delayMicroseconds(10); // Small delay to prevent busy waiting
+template <class StatsPolicy>
+uint8_t IQS5XX_B000_TrackpadT<StatsPolicy>::getSystemFlags() {
+  return readRegister8(IQS5XX_REG_SYS_FLAGS).value;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::needsReset() {
+  // SHOW_RESET in System Info 0 (16-bit address space); a failed read
+  // tells nothing about the device state
+  RegisterResult<uint8_t> info = tryReadRegister8(IQS5XX_REG_SYSTEM_INFO_0);
+  if (info.ok() && (info.value & IQS5XX_SYS_INFO0_SHOW_RESET)) {
+    // The device is back at its power-on configuration
+    invalidateShadow();
+    return true;
   }
+  return false;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::readTouchData(TouchData &touchData) {
+  // Wait for RDY pin to be LOW (device ready)
+  waitForReady(IQS5XX_WAIT_FOREVER);
   
-  // Read X coordinate (0x0016)
-  touchData.x = readRegister16_16bit(IQS5XX_REG_TOUCH_X);
-  if (touchData.x == 0) {
-    touchData.state = NO_TOUCH;
+  if (acquireTouchData(touchData) == FRAME_BUS_ERROR) {
     return false;
   }
   
-  // Read Y coordinate (0x0018)  
-  touchData.y = readRegister16_16bit(IQS5XX_REG_TOUCH_Y);
-  if (touchData.y == 0) {
+  // Only the finger count says whether a finger is present; 0 is a valid
+  // coordinate on the left and top edges
+  return touchData.state != NO_TOUCH;
+}
+
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::tryReadTouchData(TouchData &touchData, uint32_t timeoutUs) {
+  if (_wire == nullptr) {
+    return FRAME_BUS_ERROR;
+  }
+  if (!waitForReady(timeoutUs)) {
+    return FRAME_NOT_READY;
+  }
+  return acquireTouchData(touchData);
+}
+
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::poll(TouchData &touchData) {
+  return tryReadTouchData(touchData, 0);
+}
+
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::acquireTouchData(TouchData &touchData) {
+  // Read the whole XY data block (0x000D - 0x001C) in one transaction
+  // instead of addressing every register separately
+  uint8_t block[IQS5XX_XY_BLOCK_LENGTH];
+  if (readBytes16(IQS5XX_XY_BLOCK_START, block, sizeof(block)) != REGISTER_OK) {
     touchData.state = NO_TOUCH;
-    return false;
+    return FRAME_BUS_ERROR;
+  }
+  bool newWindow = consumeWindow();
+  if (_endWindowAfterRead) {
+    endCommunicationWindow();
   }
   
+  return decodeTouchData(block, touchData, newWindow);
+}
 
-  // Read gesture events 
-
-  /* 
-  bool swipeY_minus; //bit 5 GESTURE_EVENTS_0
-  bool swipeY_plus;  //bit 4 GESTURE_EVENTS_0
-  bool swipeX_plus;  //bit 3 GESTURE_EVENTS_0
-  bool swipeX_minus; //bit 2 GESTURE_EVENTS_0
-  bool pressAndHold; //bit 1 GESTURE_EVENTS_0
-  bool singleTap;    //bit 0 GESTURE_EVENTS_0
-  bool zoom;         //bit 2 GESTURE_EVENTS_1
-  bool scroll;       //bit 1 GESTURE_EVENTS_1
-  bool twoFingerTap; //bit 0 GESTURE_EVENTS_1
-  */
-  uint8_t gesture0 = readRegister8_16bit(IQS5XX_SYS_GESTURE_EVENTS_0);
-  uint8_t gesture1 = readRegister8_16bit(IQS5XX_SYS_GESTURE_EVENTS_1);
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::decodeTouchData(const uint8_t* block, TouchData &touchData, bool newWindow) {
+  uint32_t decodeStart = stats().now();
+  
+  // X coordinate (0x0016) and Y coordinate (0x0018), big-endian
+  touchData.x = (IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_X) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_X + 1);
+  touchData.y = (IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_Y) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_Y + 1);
+  
+  // Gesture events 
+  uint8_t gesture0 = IQS5XX_XY_BYTE(block, IQS5XX_SYS_GESTURE_EVENTS_0);
+  uint8_t gesture1 = IQS5XX_XY_BYTE(block, IQS5XX_SYS_GESTURE_EVENTS_1);
   touchData.swipeY_minus = (gesture0 & 0b00100000) != 0;
   touchData.swipeY_plus  = (gesture0 & 0b00010000) != 0;
   touchData.swipeX_plus  = (gesture0 & 0b00001000) != 0;
@@ -159,248 +310,832 @@ bool IQS5XX_B000_Trackpad::readTouchData(TouchData &touchData) {
   touchData.scroll       = (gesture1 & 0b00000010) != 0;
   touchData.twoFingerTap = (gesture1 & 0b00000001) != 0;
 
-  // Read touch strength (0x001A)
-  touchData.touchStrength = readRegister8_16bit(IQS5XX_REG_TOUCH_STRENGTH);
+  // Touch strength (0x001A, 16-bit) and touch area (0x001C)
+  touchData.touchStrength = (IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_STRENGTH) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_STRENGTH + 1);
+  touchData.area = IQS5XX_XY_BYTE(block, IQS5XX_REG_AREA);
   
-  // Read touch area (0x001B)
-  touchData.area = readRegister8_16bit(IQS5XX_REG_AREA);
+  // Relative movement of finger 1 (0x0012, 0x0014), signed
+  touchData.relX = (int16_t)((IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_X) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_X + 1));
+  touchData.relY = (int16_t)((IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_Y) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_Y + 1));
   
-  // Determine touch state based on coordinates and strength
-  if (touchData.touchStrength == 0) {
-    touchData.state = NO_TOUCH;
-  } else if (touchData.x == 0 && touchData.y == 0) {
+  //Get the amount of fingers touching the trackpad (0x0011)
+  touchData.numFingers = IQS5XX_XY_BYTE(block, IQS5XX_REG_NUM_FINGERS);
+  
+  // Determine touch state from the finger count alone: coordinates and
+  // strength can legitimately be 0 for a finger on the edge of the pad
+  if (touchData.numFingers == 0) {
     touchData.state = NO_TOUCH;
+  } else if (touchData.numFingers > 1) {
+    touchData.state = MULTI_TOUCH;
   } else {
-    // For now, assume single touch - multi-touch detection would need
-    // additional logic based on the specific IQS5XX variant capabilities
     touchData.state = SINGLE_TOUCH;
   }
+  touchData.events = decodeEvents(gesture0, gesture1,
+                                  IQS5XX_XY_BYTE(block, IQS5XX_REG_SYSTEM_INFO_0),
+                                  touchData.numFingers);
   
-  //Get the amount of fingers touching the trackpad
-  uint8_t numFingers = readRegister8_16bit(IQS5XX_REG_NUM_FINGERS);
-  touchData.numFingers = numFingers;
   _lastTouchData = touchData;
+  if (newWindow) {
+    _frameSequence++;
+  }
+  noteFrame();
+  stats().decode(decodeStart);
+  
+  // SHOW_RESET stays set until acknowledged, so a reset is never missed
+  if (IQS5XX_XY_BYTE(block, IQS5XX_REG_SYSTEM_INFO_0) & IQS5XX_SYS_INFO0_SHOW_RESET) {
+    invalidateShadow();
+    return FRAME_DEVICE_RESET;
+  }
+  return FRAME_READY;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::readMultiTouch(MultiTouchFrame &frame) {
+  // Wait for RDY pin to be LOW (device ready)
+  waitForReady(IQS5XX_WAIT_FOREVER);
+  
+  return acquireMultiTouch(frame) != FRAME_BUS_ERROR;
+}
+
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::tryReadMultiTouch(MultiTouchFrame &frame, uint32_t timeoutUs) {
+  if (_wire == nullptr) {
+    return FRAME_BUS_ERROR;
+  }
+  if (!waitForReady(timeoutUs)) {
+    return FRAME_NOT_READY;
+  }
+  return acquireMultiTouch(frame);
+}
+
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::acquireMultiTouch(MultiTouchFrame &frame) {
+  uint8_t block[IQS5XX_XY_BLOCK_LENGTH_FOR(IQS5XX_MAX_FINGERS)];
+  
+  // Read the header plus as many slots as the previous frame had fingers
+  // (at least one), so steady-state frames need a single burst
+  uint8_t slots = _expectedFingers;
+  uint8_t length = IQS5XX_XY_BLOCK_LENGTH_FOR(slots);
+  if (readBytes16(IQS5XX_XY_BLOCK_START, block, length) != REGISTER_OK) {
+    return FRAME_BUS_ERROR;
+  }
+  
+  uint8_t numFingers = IQS5XX_XY_BYTE(block, IQS5XX_REG_NUM_FINGERS);
+  if (numFingers > IQS5XX_MAX_FINGERS) {
+    numFingers = IQS5XX_MAX_FINGERS;
+  }
+  
+  // More fingers landed since the last frame - fetch the missing slots
+  if (numFingers > slots) {
+    uint8_t extra = IQS5XX_XY_BLOCK_LENGTH_FOR(numFingers) - length;
+    if (readBytes16(IQS5XX_XY_BLOCK_START + length, block + length, extra) != REGISTER_OK) {
+      return FRAME_BUS_ERROR;
+    }
+  }
+  _expectedFingers = (numFingers > 0) ? numFingers : 1;
+  consumeWindow();
+  if (_endWindowAfterRead) {
+    endCommunicationWindow();
+  }
+  
+  uint32_t decodeStart = stats().now();
+  frame.numFingers = numFingers;
+  frame.gestureEvents0 = IQS5XX_XY_BYTE(block, IQS5XX_SYS_GESTURE_EVENTS_0);
+  frame.gestureEvents1 = IQS5XX_XY_BYTE(block, IQS5XX_SYS_GESTURE_EVENTS_1);
+  frame.systemInfo0 = IQS5XX_XY_BYTE(block, IQS5XX_REG_SYSTEM_INFO_0);
+  frame.systemInfo1 = IQS5XX_XY_BYTE(block, IQS5XX_REG_SYSTEM_INFO_1);
+  frame.relX = (int16_t)((IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_X) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_X + 1));
+  frame.relY = (int16_t)((IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_Y) << 8) | IQS5XX_XY_BYTE(block, IQS5XX_REG_REL_Y + 1));
+  
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    if (i >= numFingers) {
+      frame.x[i] = 0;
+      frame.y[i] = 0;
+      frame.strength[i] = 0;
+      frame.area[i] = 0;
+      continue;
+    }
+    const uint8_t* slot = &IQS5XX_XY_BYTE(block, IQS5XX_REG_TOUCH_X) + i * IQS5XX_FINGER_STRIDE;
+    frame.x[i] = (slot[IQS5XX_FINGER_X] << 8) | slot[IQS5XX_FINGER_X + 1];
+    frame.y[i] = (slot[IQS5XX_FINGER_Y] << 8) | slot[IQS5XX_FINGER_Y + 1];
+    frame.strength[i] = (slot[IQS5XX_FINGER_STRENGTH] << 8) | slot[IQS5XX_FINGER_STRENGTH + 1];
+    frame.area[i] = slot[IQS5XX_FINGER_AREA];
+  }
+  
+  frame.events = decodeEvents(frame.gestureEvents0, frame.gestureEvents1,
+                              frame.systemInfo0, numFingers);
+  noteFrame();
+  stats().decode(decodeStart);
+  
+  if (frame.systemInfo0 & IQS5XX_SYS_INFO0_SHOW_RESET) {
+    invalidateShadow();
+    return FRAME_DEVICE_RESET;
+  }
+  return FRAME_READY;
+}
+
+template <class StatsPolicy>
+uint8_t IQS5XX_B000_TrackpadT<StatsPolicy>::decodeEvents(uint8_t gesture0, uint8_t gesture1, uint8_t systemInfo0, uint8_t numFingers) {
+  uint8_t events = 0;
+  if (gesture0 != 0 || gesture1 != 0) {
+    events |= IQS5XX_EVENT_GESTURE;
+  }
+  // Fingers present, or the finger count changed (lift-off)
+  if (numFingers != 0 || numFingers != _lastNumFingers) {
+    events |= IQS5XX_EVENT_TP;
+  }
+  if (systemInfo0 & IQS5XX_SYS_INFO0_REATI) {
+    events |= IQS5XX_EVENT_REATI;
+  }
+  _lastNumFingers = numFingers;
+  return events;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::windowReady() {
+  // The window stays open until the I2C timeout after the last access, so
+  // RDY LOW alone does not mean a new frame: once a window has been read,
+  // RDY has to go HIGH before the next LOW counts
+  if (digitalRead(_readyPin) == HIGH) {
+    _windowConsumed = false;
+    return false;
+  }
+  // A poll period that aliases with the report cycle may never see RDY
+  // HIGH, but the window that was read has closed once the timeout expired
+  if (_windowConsumed && (uint32_t)(micros() - _lastAccessUs) > windowTimeoutUs()) {
+    _windowConsumed = false;
+  }
+  return !_windowConsumed;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::consumeWindow() {
+  bool newWindow = !_windowConsumed;
+  _windowConsumed = true;
+  return newWindow;
+}
+
+template <class StatsPolicy>
+uint32_t IQS5XX_B000_TrackpadT<StatsPolicy>::windowTimeoutUs() const {
+  uint8_t timeoutMs = IQS5XX_I2C_TIMEOUT_DEFAULT_MS;
+  shadowRead(IQS5XX_REG_I2C_TIMEOUT, &timeoutMs, 1);
+  return (uint32_t)(timeoutMs ? timeoutMs : 1) * 1000;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::waitForReady(uint32_t timeoutUs) {
+  uint32_t start = micros();
+  while (!windowReady()) {
+    if (timeoutUs != IQS5XX_WAIT_FOREVER && (uint32_t)(micros() - start) >= timeoutUs) {
+      // poll() checking once is not a timeout
+      if (timeoutUs != 0) {
+        stats().rdyWait(start, false);
+      }
+      return false;
+    }
+    delayMicroseconds(10); // Small delay to prevent busy waiting
+  }
+  stats().rdyWait(start, true);
   return true;
 }
 
-TouchState IQS5XX_B000_Trackpad::getTouchState() {
-  TouchData touchData;
-  if (readTouchData(touchData)) {
-    return touchData.state;
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::beginInterruptMode() {
+  if (_wire == nullptr) {
+    return false;
+  }
+  if (_interruptInstance != nullptr && _interruptInstance != this) {
+    // Another trackpad already owns the interrupt handler
+    return false;
   }
-  return NO_TOUCH;
+  
+  _frameQueue.clear();
+  _interruptInstance = this;
+  _interruptMode = true;
+  attachInterrupt(digitalPinToInterrupt(_readyPin), onReadyInterrupt, FALLING);
+  
+  // RDY may already be asserted, in which case no edge will follow
+  _framePending = windowReady();
+  return true;
 }
 
-uint16_t IQS5XX_B000_Trackpad::getTouchX() {
-  TouchData touchData;
-  if (readTouchData(touchData) && touchData.state != NO_TOUCH) {
-    return touchData.x;
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::endInterruptMode() {
+  if (!_interruptMode) {
+    return;
   }
-  return 0;
+  
+  detachInterrupt(digitalPinToInterrupt(_readyPin));
+  _interruptMode = false;
+  _framePending = false;
+  _interruptInstance = nullptr;
+  _frameQueue.clear();
 }
 
-uint16_t IQS5XX_B000_Trackpad::getTouchY() {
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::service() {
+  if (_backend != nullptr) {
+    TouchData touchData;
+    FrameStatus status = pollAsync(touchData);
+    if (status != FRAME_READY && status != FRAME_DEVICE_RESET) {
+      return false;
+    }
+    return _frameQueue.push(touchData);
+  }
+  
+  if (!_framePending) {
+    return false;
+  }
+  // The falling edge started a new window
+  _framePending = false;
+  _windowConsumed = false;
+  
   TouchData touchData;
-  if (readTouchData(touchData) && touchData.state != NO_TOUCH) {
-    return touchData.y;
+  if (acquireTouchData(touchData) == FRAME_BUS_ERROR) {
+    return false;
   }
-  return 0;
+  
+  return _frameQueue.push(touchData);
 }
 
-uint8_t IQS5XX_B000_Trackpad::getTouchStrength() {
-  TouchData touchData;
-  if (readTouchData(touchData) && touchData.state != NO_TOUCH) {
-    return touchData.touchStrength;
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::setI2CBackend(IQS5XX_I2CBackend* backend) {
+  if (_backend != nullptr && _asyncState != ASYNC_IDLE) {
+    // The old backend still writes into _transfer and _asyncBlock until
+    // the transfer completes
+    _backend->poll();
+    if (_transfer.status == I2C_TRANSFER_BUSY) {
+      return false;
+    }
   }
-  return 0;
+  // A finished read that was not decoded yet is dropped; its window was
+  // not consumed, so the next call reads it again
+  _backend = backend;
+  _asyncState = ASYNC_IDLE;
+  return true;
 }
 
-uint8_t IQS5XX_B000_Trackpad::getTouchArea() {
-  TouchData touchData;
-  if (readTouchData(touchData) && touchData.state != NO_TOUCH) {
-    return touchData.area;
+template <class StatsPolicy>
+FrameStatus IQS5XX_B000_TrackpadT<StatsPolicy>::pollAsync(TouchData &touchData) {
+  if (_backend == nullptr) {
+    return poll(touchData);
+  }
+  _backend->poll();
+  
+  if (_asyncState == ASYNC_END_WINDOW) {
+    if (_transfer.status == I2C_TRANSFER_BUSY) {
+      return FRAME_NOT_READY;
+    }
+    // A failed end-window write is harmless: the window then closes on the I2C timeout
+    bool ended = (_transfer.status == I2C_TRANSFER_DONE);
+    countTransaction(_transfer.txLength, 0, ended);
+    if (ended) {
+      _windowConsumed = false;
+    }
+    _asyncState = ASYNC_IDLE;
+  }
+  
+  if (_asyncState == ASYNC_IDLE) {
+    if (_interruptMode) {
+      if (!_framePending) {
+        return FRAME_NOT_READY;
+      }
+      // The falling edge started a new window
+      _windowConsumed = false;
+    } else if (!windowReady()) {
+      return FRAME_NOT_READY;
+    }
+    if (!submitTransfer(IQS5XX_XY_BLOCK_START, nullptr, 0, _asyncBlock, sizeof(_asyncBlock))) {
+      // The frame stays pending and is read by the next call
+      return FRAME_BUS_ERROR;
+    }
+    _framePending = false;
+    _asyncState = ASYNC_READ;
+  }
+  
+  // ASYNC_READ: backends like Wire complete inside submit()
+  if (_transfer.status == I2C_TRANSFER_BUSY) {
+    return FRAME_NOT_READY;
+  }
+  _asyncState = ASYNC_IDLE;
+  if (_transfer.status != I2C_TRANSFER_DONE) {
+    countTransaction(_transfer.txLength, 0, false);
+    touchData.state = NO_TOUCH;
+    return FRAME_BUS_ERROR;
+  }
+  countTransaction(_transfer.txLength, _transfer.rxLength);
+  bool newWindow = consumeWindow();
+  
+  if (_endWindowAfterRead) {
+    // The device only needs the address; the data byte is ignored
+    const uint8_t ignored = 0x00;
+    if (submitTransfer(IQS5XX_REG_END_COMM_WINDOW, &ignored, 1, nullptr, 0)) {
+      _asyncState = ASYNC_END_WINDOW;
+    }
+  }
+  
+  return decodeTouchData(_asyncBlock, touchData, newWindow);
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::submitTransfer(uint16_t reg, const uint8_t* data, uint8_t writeLength, uint8_t* rx, uint8_t readLength) {
+  if (writeLength + 2 > IQS5XX_I2C_MAX_WRITE) {
+    return false;
+  }
+  
+  _transfer.address = _address;
+  _transfer.tx[0] = (reg >> 8) & 0xFF; // High byte of address
+  _transfer.tx[1] = reg & 0xFF;        // Low byte of address
+  for (uint8_t i = 0; i < writeLength; i++) {
+    _transfer.tx[2 + i] = data[i];
+  }
+  _transfer.txLength = 2 + writeLength;
+  _transfer.rx = rx;
+  _transfer.rxLength = readLength;
+  _transfer.callback = nullptr;
+  _transfer.context = nullptr;
+  stats().startTransfer();
+  return _backend->submit(_transfer);
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::popFrame(TouchData &touchData) {
+  return _frameQueue.pop(touchData);
+}
+
+template <class StatsPolicy>
+uint8_t IQS5XX_B000_TrackpadT<StatsPolicy>::framesAvailable() const {
+  return _frameQueue.size();
+}
+
+template <class StatsPolicy>
+uint32_t IQS5XX_B000_TrackpadT<StatsPolicy>::getDroppedFrames() const {
+  return _frameQueue.dropped();
+}
+
+template <class StatsPolicy>
+void IRAM_ATTR IQS5XX_B000_TrackpadT<StatsPolicy>::onReadyInterrupt() {
+  if (_interruptInstance != nullptr) {
+    _interruptInstance->_framePending = true;
   }
-  return 0;
 }
 
-bool IQS5XX_B000_Trackpad::softReset() {
-  // Implementation would depend on specific reset procedure for IQS5XX-B000
-  // This is a placeholder for the reset functionality
-  return writeRegister8(IQS5XX_REG_SYS_FLAGS, IQS5XX_SYS_FLAG_RESET);
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::update() {
+  // Wait for RDY pin to be LOW (device ready)
+  waitForReady(IQS5XX_WAIT_FOREVER);
+  
+  TouchData touchData;
+  return acquireTouchData(touchData) != FRAME_BUS_ERROR;
+}
+
+template <class StatsPolicy>
+const TouchData& IQS5XX_B000_TrackpadT<StatsPolicy>::getLastTouchData() const {
+  return _lastTouchData;
+}
+
+template <class StatsPolicy>
+uint32_t IQS5XX_B000_TrackpadT<StatsPolicy>::getFrameSequence() const {
+  return _frameSequence;
+}
+
+template <class StatsPolicy>
+TouchState IQS5XX_B000_TrackpadT<StatsPolicy>::getTouchState() const {
+  return _lastTouchData.state;
+}
+
+template <class StatsPolicy>
+uint16_t IQS5XX_B000_TrackpadT<StatsPolicy>::getTouchX() const {
+  return (_lastTouchData.state != NO_TOUCH) ? _lastTouchData.x : 0;
+}
+
+template <class StatsPolicy>
+uint16_t IQS5XX_B000_TrackpadT<StatsPolicy>::getTouchY() const {
+  return (_lastTouchData.state != NO_TOUCH) ? _lastTouchData.y : 0;
 }
 
-bool IQS5XX_B000_Trackpad::wakeupDevice() {
+template <class StatsPolicy>
+uint16_t IQS5XX_B000_TrackpadT<StatsPolicy>::getTouchStrength() const {
+  return (_lastTouchData.state != NO_TOUCH) ? _lastTouchData.touchStrength : 0;
+}
+
+template <class StatsPolicy>
+uint8_t IQS5XX_B000_TrackpadT<StatsPolicy>::getTouchArea() const {
+  return (_lastTouchData.state != NO_TOUCH) ? _lastTouchData.area : 0;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::softReset() {
+  // RESET in System Control 1 restarts the device with its power-on
+  // configuration (the write also drops the shadow)
+  invalidateShadow();
+  return writeRegister8_16bit(IQS5XX_REG_SYS_CNT1, IQS5XX_SYS_CNT1_RESET);
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::wakeupDevice() {
   if (_wire == nullptr) {
     return false;
   }
   
   // First attempt - expect NACK (device is sleeping)
-  _wire->beginTransmission(_address);
+  startTransaction();
   uint8_t result1 = _wire->endTransmission();
+  countTransaction(0, 0, result1 == 0);
   
   // Wait at least 150µs as required by datasheet
   delayMicroseconds(200); // 200µs to be safe
   
   // Second attempt - should get ACK if wakeup was successful
-  _wire->beginTransmission(_address);
+  startTransaction();
   uint8_t result2 = _wire->endTransmission();
+  countTransaction(0, 0, result2 == 0);
   
   return (result2 == 0);
 }
 
-bool IQS5XX_B000_Trackpad::enableManualControl() {
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::enableManualControl() {
   if (_wire == nullptr) {
     return false;
   }
   
-  // Read current System Configuration 0 register (0x058E)
-  uint8_t sysConf0 = readRegister8_16bit(IQS5XX_REG_SYS_CFG0);
-  
-  // Set bit 7 to 1 to enable manual control
-  sysConf0 |= 0b10000000;
+  // Read current System Configuration 0 register (0x058E). Writing back
+  // after a failed read would clear every other bit in the register.
+  RegisterResult<uint8_t> sysConf0 = tryReadRegister8(IQS5XX_REG_SYS_CFG0);
+  if (!sysConf0.ok()) {
+    return false;
+  }
   
-  // Write back the modified value
-  return writeRegister8_16bit(IQS5XX_REG_SYS_CFG0, sysConf0);
+  // Set bit 7 to 1 to enable manual control and write back the modified value
+  return writeRegister8_16bit(IQS5XX_REG_SYS_CFG0, sysConf0.value | IQS5XX_SYS_CFG0_MANUAL_CONTROL);
 }
 
-bool IQS5XX_B000_Trackpad::isReadyForData() {
-  return digitalRead(_readyPin) == LOW;
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::acknowledgeReset() {
+  // Keep the power mode a profile may have selected; a raw ACK_RESET
+  // write would set MODE_SELECT back to 0
+  RegisterResult<uint8_t> control = tryReadRegister8(IQS5XX_REG_SYS_CNT0);
+  if (!control.ok()) {
+    return false;
+  }
+  uint8_t value = (control.value & IQS5XX_SYS_CNT0_MODE_SELECT) | IQS5XX_SYS_CNT0_ACK_RESET;
+  return writeRegister8_16bit(IQS5XX_REG_SYS_CNT0, value);
 }
 
-uint8_t IQS5XX_B000_Trackpad::readRegister8(uint8_t reg) {
-  if (_wire == nullptr) {
-    return 0;
-  }
-  
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
-  
-  if (_wire->endTransmission() != 0) {
-    return 0;
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::endCommunicationWindow() {
+  // The device only needs the address; the data byte is ignored
+  if (!writeRegister8_16bit(IQS5XX_REG_END_COMM_WINDOW, 0x00)) {
+    return false;
   }
-  
-  if (_wire->requestFrom(_address, (uint8_t)1) != 1) {
-    return 0;
+  // The window is closed: the next RDY LOW is a new one
+  _windowConsumed = false;
+  return true;
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::setEndWindowAfterRead(bool enable) {
+  _endWindowAfterRead = enable;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::setEventMode(uint8_t events) {
+  if (events != 0) {
+    events |= IQS5XX_EVENT_MODE;
   }
-  
-  return _wire->read();
+  return writeRegister8_16bit(IQS5XX_REG_SYS_CFG1, events);
 }
 
-uint8_t IQS5XX_B000_Trackpad::readRegister8_16bit(uint16_t reg) {
-  if (_wire == nullptr) {
-    return 0;
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::setDeviceGestures(uint8_t singleFinger, uint8_t multiFinger) {
+  const uint8_t enables[2] = {singleFinger, multiFinger};
+  return writeBytes16(IQS5XX_REG_SINGLE_FINGER_GESTURES, enables, sizeof(enables));
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::isReadyForData() {
+  return windowReady();
+}
+
+template <class StatsPolicy>
+RegisterResult<uint8_t> IQS5XX_B000_TrackpadT<StatsPolicy>::readRegister8(uint8_t reg) {
+  RegisterResult<uint8_t> result = {0, REGISTER_OK};
+  result.status = readBytes(reg, &result.value, 1);
+  if (!result.ok()) {
+    result.value = 0;
   }
-  
-  _wire->beginTransmission(_address);
-  _wire->write((reg >> 8) & 0xFF); // High byte of address
-  _wire->write(reg & 0xFF);        // Low byte of address
-  
-  if (_wire->endTransmission() != 0) {
-    return 0;
+  return result;
+}
+
+template <class StatsPolicy>
+RegisterResult<uint8_t> IQS5XX_B000_TrackpadT<StatsPolicy>::tryReadRegister8(uint16_t reg) {
+  RegisterResult<uint8_t> result = {0, REGISTER_OK};
+  if (_wire != nullptr && shadowRead(reg, &result.value, 1)) {
+    return result;
   }
   
-  if (_wire->requestFrom(_address, (uint8_t)1) != 1) {
-    return 0;
+  result.status = readBytes16(reg, &result.value, 1);
+  if (!result.ok()) {
+    result.value = 0;
+    return result;
   }
-  
-  return _wire->read();
+  shadowStore(reg, &result.value, 1);
+  return result;
 }
 
-uint16_t IQS5XX_B000_Trackpad::readRegister16(uint8_t reg) {
+template <class StatsPolicy>
+RegisterResult<uint16_t> IQS5XX_B000_TrackpadT<StatsPolicy>::readRegister16(uint8_t reg) {
+  RegisterResult<uint16_t> result = {0, REGISTER_OK};
   uint8_t buffer[2];
-  if (!readBytes(reg, buffer, 2)) {
-    return 0;
+  result.status = readBytes(reg, buffer, 2);
+  if (result.ok()) {
+    // Assuming little-endian format
+    result.value = (buffer[1] << 8) | buffer[0];
   }
-  
-  // Assuming little-endian format
-  return (buffer[1] << 8) | buffer[0];
+  return result;
 }
 
-uint16_t IQS5XX_B000_Trackpad::readRegister16_16bit(uint16_t reg) {
-  if (_wire == nullptr) {
-    return 0;
+template <class StatsPolicy>
+RegisterResult<uint16_t> IQS5XX_B000_TrackpadT<StatsPolicy>::tryReadRegister16(uint16_t reg) {
+  RegisterResult<uint16_t> result = {0, REGISTER_OK};
+  uint8_t bytes[2];
+  if (_wire != nullptr && shadowRead(reg, bytes, 2)) {
+    result.value = (bytes[0] << 8) | bytes[1];
+    return result;
   }
   
-  _wire->beginTransmission(_address);
-  _wire->write((reg >> 8) & 0xFF); // High byte of address
-  _wire->write(reg & 0xFF);        // Low byte of address
-  
-  if (_wire->endTransmission() != 0) {
-    return 0;
+  result.status = readBytes16(reg, bytes, 2);
+  if (!result.ok()) {
+    return result;
   }
-  
-  if (_wire->requestFrom(_address, (uint8_t)2) != 2) {
-    return 0;
-  }
-  
-  uint8_t high = _wire->read();
-  uint8_t low = _wire->read();
-  
-  return (high << 8) | low;
+  shadowStore(reg, bytes, 2);
+  result.value = (bytes[0] << 8) | bytes[1];
+  return result;
 }
 
-bool IQS5XX_B000_Trackpad::writeRegister8(uint8_t reg, uint8_t value) {
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::writeRegister8(uint8_t reg, uint8_t value) {
   if (_wire == nullptr) {
     return false;
   }
   
-  _wire->beginTransmission(_address);
+  startTransaction();
   _wire->write(reg);
   _wire->write(value);
   
-  return (_wire->endTransmission() == 0);
+  bool ok = (_wire->endTransmission() == 0);
+  countTransaction(2, 0, ok);
+  return ok;
 }
 
-bool IQS5XX_B000_Trackpad::writeRegister8_16bit(uint16_t reg, uint8_t value) {
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::writeRegister8_16bit(uint16_t reg, uint8_t value) {
   if (_wire == nullptr) {
     return false;
   }
+  if (shadowMatches(reg, &value, 1)) {
+    return true;
+  }
   
-  _wire->beginTransmission(_address);
+  startTransaction();
   _wire->write((reg >> 8) & 0xFF); // High byte of address
   _wire->write(reg & 0xFF);        // Low byte of address
   _wire->write(value);
   
-  return (_wire->endTransmission() == 0);
+  bool ok = (_wire->endTransmission() == 0);
+  countTransaction(3, 0, ok);
+  shadowStore(reg, ok ? &value : nullptr, 1);
+  return ok;
 }
-bool IQS5XX_B000_Trackpad::writeRegister16(uint16_t reg, uint16_t value) {
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::writeRegister16(uint16_t reg, uint16_t value) {
   if (_wire == nullptr) {
     return false;
   }
+  uint8_t bytes[2] = {(uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+  if (shadowMatches(reg, bytes, 2)) {
+    return true;
+  }
 
-  _wire->beginTransmission(_address);
+  startTransaction();
   _wire->write((reg >> 8) & 0xFF); // High byte of address
   _wire->write(reg & 0xFF);        // Low byte of address
   _wire->write((value >> 8) & 0xFF); // High byte of value
   _wire->write(value & 0xFF);        // Low byte of value
 
-  return (_wire->endTransmission() == 0);
+  bool ok = (_wire->endTransmission() == 0);
+  countTransaction(4, 0, ok);
+  shadowStore(reg, ok ? bytes : nullptr, 2);
+  return ok;
 }
 
-bool IQS5XX_B000_Trackpad::readBytes(uint8_t reg, uint8_t* buffer, uint8_t length) {
+template <class StatsPolicy>
+RegisterStatus IQS5XX_B000_TrackpadT<StatsPolicy>::readBytes(uint8_t reg, uint8_t* buffer, uint8_t length) {
   if (_wire == nullptr || buffer == nullptr || length == 0) {
-    return false;
+    return REGISTER_NO_BUS;
   }
   
-  _wire->beginTransmission(_address);
+  startTransaction();
   _wire->write(reg);
   
   if (_wire->endTransmission() != 0) {
-    return false;
+    countTransaction(1, 0, false);
+    return REGISTER_NACK;
   }
   
-  if (_wire->requestFrom(_address, length) != length) {
-    return false;
+  uint8_t received = _wire->requestFrom(_address, length);
+  if (received != length) {
+    countTransaction(1, 0, false);
+    return (received == 0) ? REGISTER_NACK : REGISTER_SHORT_READ;
   }
+  countTransaction(1, length);
   
   for (uint8_t i = 0; i < length; i++) {
     buffer[i] = _wire->read();
   }
   
+  return REGISTER_OK;
+}
+
+template <class StatsPolicy>
+RegisterStatus IQS5XX_B000_TrackpadT<StatsPolicy>::readBytes16(uint16_t reg, uint8_t* buffer, uint8_t length) {
+  if (_wire == nullptr || buffer == nullptr || length == 0) {
+    return REGISTER_NO_BUS;
+  }
+  
+  // The device auto-increments the address pointer, so a block comes back
+  // in a single read. Blocks larger than the Wire buffer are split.
+  while (length > 0) {
+    uint8_t chunk = (length > IQS5XX_MAX_BURST) ? IQS5XX_MAX_BURST : length;
+    
+    startTransaction();
+    _wire->write((reg >> 8) & 0xFF); // High byte of address
+    _wire->write(reg & 0xFF);        // Low byte of address
+    
+    if (_wire->endTransmission() != 0) {
+      countTransaction(2, 0, false);
+      return REGISTER_NACK;
+    }
+    
+    uint8_t received = _wire->requestFrom(_address, chunk);
+    if (received != chunk) {
+      countTransaction(2, 0, false);
+      return (received == 0) ? REGISTER_NACK : REGISTER_SHORT_READ;
+    }
+    countTransaction(2, chunk);
+    
+    for (uint8_t i = 0; i < chunk; i++) {
+      buffer[i] = _wire->read();
+    }
+    
+    reg += chunk;
+    buffer += chunk;
+    length -= chunk;
+  }
+  
+  return REGISTER_OK;
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::invalidateShadow() {
+  _shadowValid = 0;
+}
+
+template <class StatsPolicy>
+int8_t IQS5XX_B000_TrackpadT<StatsPolicy>::shadowIndex(uint16_t reg) const {
+  if (reg >= IQS5XX_SHADOW_CNT_START && reg < IQS5XX_SHADOW_CNT_START + IQS5XX_SHADOW_CNT_LENGTH) {
+    return reg - IQS5XX_SHADOW_CNT_START;
+  }
+  if (reg >= IQS5XX_SHADOW_CFG_START && reg < IQS5XX_SHADOW_CFG_START + IQS5XX_SHADOW_CFG_LENGTH) {
+    return IQS5XX_SHADOW_CNT_LENGTH + (reg - IQS5XX_SHADOW_CFG_START);
+  }
+  return -1;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::shadowRead(uint16_t reg, uint8_t* data, uint8_t length) const {
+  for (uint8_t i = 0; i < length; i++) {
+    int8_t index = shadowIndex(reg + i);
+    if (index < 0 || !(_shadowValid & (1UL << index))) {
+      return false;
+    }
+    data[i] = _shadow[index];
+  }
+  return true;
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::shadowMatches(uint16_t reg, const uint8_t* data, uint8_t length) const {
+  for (uint8_t i = 0; i < length; i++) {
+    uint16_t address = reg + i;
+    int8_t index = shadowIndex(address);
+    if (index < 0 || !(_shadowValid & (1UL << index)) || _shadow[index] != data[i]) {
+      return false;
+    }
+    if ((address == IQS5XX_REG_SYS_CNT0 && (data[i] & IQS5XX_SYS_CNT0_COMMANDS)) ||
+        (address == IQS5XX_REG_SYS_CNT1 && (data[i] & IQS5XX_SYS_CNT1_COMMANDS))) {
+      return false;
+    }
+  }
   return true;
 }
 
-bool IQS5XX_B000_Trackpad::increaseSpeed() {
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::shadowStore(uint16_t reg, const uint8_t* data, uint8_t length) {
+  for (uint8_t i = 0; i < length; i++) {
+    uint16_t address = reg + i;
+    int8_t index = shadowIndex(address);
+    if (index < 0) {
+      continue;
+    }
+    if (data == nullptr) {
+      _shadowValid &= ~(1UL << index);
+      continue;
+    }
+    
+    if (address == IQS5XX_REG_SYS_CNT1 && (data[i] & IQS5XX_SYS_CNT1_RESET)) {
+      // The device restarts with its power-on configuration
+      invalidateShadow();
+      return;
+    }
+    
+    // Command bits clear themselves once the device has acted on them
+    uint8_t value = data[i];
+    if (address == IQS5XX_REG_SYS_CNT0) {
+      value &= ~IQS5XX_SYS_CNT0_COMMANDS;
+    } else if (address == IQS5XX_REG_SYS_CNT1) {
+      value &= ~IQS5XX_SYS_CNT1_COMMANDS;
+    }
+    _shadow[index] = value;
+    _shadowValid |= (1UL << index);
+  }
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::writeBytes16(uint16_t reg, const uint8_t* data, uint8_t length) {
+  if (_wire == nullptr || data == nullptr || length == 0 || length > IQS5XX_CONFIG_MAX_BURST) {
+    return false;
+  }
+  if (shadowMatches(reg, data, length)) {
+    return true;
+  }
+  
+  startTransaction();
+  _wire->write((reg >> 8) & 0xFF); // High byte of address
+  _wire->write(reg & 0xFF);        // Low byte of address
+  _wire->write(data, length);
+  
+  bool ok = (_wire->endTransmission() == 0);
+  countTransaction(2 + length, 0, ok);
+  shadowStore(reg, ok ? data : nullptr, length);
+  return ok;
+}
+
+template <class StatsPolicy>
+BusStats IQS5XX_B000_TrackpadT<StatsPolicy>::getBusStats() const {
+  return _busStats;
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::resetBusStats() {
+  _busStats.transactions = 0;
+  _busStats.bytesWritten = 0;
+  _busStats.bytesRead = 0;
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::countTransaction(uint8_t written, uint8_t read, bool ok) {
+  _lastAccessUs = micros();
+  _busStats.transactions++;
+  _busStats.bytesWritten += written;
+  _busStats.bytesRead += read;
+  stats().transfer(written, read, ok);
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::startTransaction() {
+  stats().startTransfer();
+  _wire->beginTransmission(_address);
+}
+
+template <class StatsPolicy>
+TrackpadStats IQS5XX_B000_TrackpadT<StatsPolicy>::getStats() const {
+  return stats().snapshot();
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::resetStats() {
+  stats().reset();
+}
+
+template <class StatsPolicy>
+void IQS5XX_B000_TrackpadT<StatsPolicy>::printStats(Print &out) const {
+  IQS5XX_printStats(out, stats().snapshot());
+}
+
+template <class StatsPolicy>
+bool IQS5XX_B000_TrackpadT<StatsPolicy>::increaseSpeed() {
   //Set the I2C timeout (0x058A) to a lower value (e.g., 5ms)
   //This means that the RDY pin is only LOW for 5 ms
   if (!writeRegister8_16bit(IQS5XX_REG_I2C_TIMEOUT, 5)){
@@ -413,4 +1148,8 @@ bool IQS5XX_B000_Trackpad::increaseSpeed() {
     return false;
   }
   return true;
-}
\ No newline at end of file
+}
+
+// Definitions stay in this file: instantiate the policies the library ships
+template class IQS5XX_B000_TrackpadT<IQS5XX_NullStats>;
+template class IQS5XX_B000_TrackpadT<IQS5XX_StatsRecorder>;
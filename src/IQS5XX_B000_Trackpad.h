@@ -16,6 +16,10 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "IQS5XX_FrameQueue.h"
+#include "IQS5XX_AsyncI2C.h"
+#include "IQS5XX_ConfigProfile.h"
+#include "IQS5XX_Stats.h"
 
 //Datasheet https://www.azoteq.com/images/stories/pdf/iqs5xx-b000_trackpad_datasheet.pdf#page=31
 
@@ -23,6 +27,22 @@
 // Default I2C address for IQS5XX-B000
 #define IQS5XX_DEFAULT_ADDRESS 0x74
 
+// Largest number of bytes requested from Wire in one read. Longer bursts
+// are split into several addressed reads. ESP32 can raise this to 128.
+#ifndef IQS5XX_MAX_BURST
+#define IQS5XX_MAX_BURST 32
+#endif
+
+// Number of decoded frames buffered in interrupt mode (power of two)
+#ifndef IQS5XX_FRAME_QUEUE_SIZE
+#define IQS5XX_FRAME_QUEUE_SIZE 8
+#endif
+
+// Interrupt handlers must live in IRAM on ESP32; no-op elsewhere
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
 // Device Information Registers (0x00 - 0x0F)
 #define IQS5XX_REG_PRODUCT_NUMBER     0x00    // Product number
 #define IQS5XX_REG_SOFTWARE_NUMBER    0x02    // Software number
@@ -31,17 +51,28 @@
 #define IQS5XX_REG_BL_STATUS          0x06    // Bootloader status
 
 // System Information Registers (0x10 - 0x1F)
+#define IQS5XX_REG_SYSTEM_INFO_0      0x0F    // System info 0 (reset, ATI status)
+#define IQS5XX_REG_SYSTEM_INFO_1      0x10    // System info 1 (palm, too many fingers)
 #define IQS5XX_REG_SYSTEM_FLAGS       0x10    // System flags
 #define IQS5XX_REG_XY_INFO0           0x11    // Number of touches and palm rejection info
 #define IQS5XX_REG_REL_X              0x12    // Relative X coordinate
 #define IQS5XX_REG_REL_Y              0x14    // Relative Y coordinate
 #define IQS5XX_REG_TOUCH_X            0x16    // Absolute X coordinate
 #define IQS5XX_REG_TOUCH_Y            0x18    // Absolute Y coordinate
-#define IQS5XX_REG_TOUCH_STRENGTH     0x1A    // Touch strength
-#define IQS5XX_REG_AREA               0x1B    // Touch area
+#define IQS5XX_REG_TOUCH_STRENGTH     0x1A    // Touch strength (16-bit)
+#define IQS5XX_REG_AREA               0x1C    // Touch area
 
 #define IQS5XX_REG_ACTIVE_REPORT_RATE 0x057A  // Active report rate
-#define IQS5XX_REG_I2C_TIMEOUT        0x058A  // I2C timeout
+#define IQS5XX_REG_IDLE_TOUCH_REPORT_RATE 0x057C  // Idle touch report rate
+#define IQS5XX_REG_IDLE_REPORT_RATE   0x057E  // Idle report rate
+#define IQS5XX_REG_ACTIVE_TIMEOUT     0x0584  // Active mode timeout (s)
+#define IQS5XX_REG_I2C_TIMEOUT        0x058A  // I2C timeout (ms)
+
+// I2C timeout after power-on, used until the register is cached
+#define IQS5XX_I2C_TIMEOUT_DEFAULT_MS 10
+
+// Writing any byte to this address ends the communication window
+#define IQS5XX_REG_END_COMM_WINDOW    0xEEEE
 
 // System Configuration Registers (0x430 - 0x43F)
 #define IQS5XX_REG_SYS_CNT0           0x0431  // System control 0
@@ -65,10 +96,75 @@
 #define IQS5XX_SYS_FLAG_SNAP          0x02
 #define IQS5XX_SYS_FLAG_SETUP         0x01
 
+// System Info 0 bits
+#define IQS5XX_SYS_INFO0_SHOW_RESET   0x80
+#define IQS5XX_SYS_INFO0_REATI        0x10
+
+// System Control 0/1 bits
+#define IQS5XX_SYS_CNT0_ACK_RESET     0x80
+#define IQS5XX_SYS_CNT0_AUTO_ATI      0x20
+#define IQS5XX_SYS_CNT0_ALP_RESEED    0x10
+#define IQS5XX_SYS_CNT0_RESEED        0x08
+#define IQS5XX_SYS_CNT0_MODE_SELECT   0x07    // Persistent power mode field, not a command
+#define IQS5XX_SYS_CNT1_RESET         0x02
+#define IQS5XX_SYS_CNT1_SUSPEND       0x01
+
+// Self-clearing command bits: writes carrying them always reach the device
+#define IQS5XX_SYS_CNT0_COMMANDS      (IQS5XX_SYS_CNT0_ACK_RESET | IQS5XX_SYS_CNT0_AUTO_ATI | \
+                                       IQS5XX_SYS_CNT0_ALP_RESEED | IQS5XX_SYS_CNT0_RESEED)
+#define IQS5XX_SYS_CNT1_COMMANDS      IQS5XX_SYS_CNT1_RESET
+
+// System Configuration 0 bits
+#define IQS5XX_SYS_CFG0_MANUAL_CONTROL 0x80
+
+// System Configuration 1 bits (event mode). With IQS5XX_EVENT_MODE set, RDY
+// only asserts when one of the enabled event classes occurred.
+#define IQS5XX_EVENT_MODE             0x01    // Only open a window on enabled events
+#define IQS5XX_EVENT_GESTURE          0x02    // Gesture events
+#define IQS5XX_EVENT_TP               0x04    // Trackpad events (touch, movement, lift-off)
+#define IQS5XX_EVENT_REATI            0x08    // Re-ATI occurred
+#define IQS5XX_EVENT_ALP_PROX         0x10    // ALP channel proximity
+#define IQS5XX_EVENT_SNAP             0x20    // Snap state change
+#define IQS5XX_EVENT_TOUCH            0x40    // Touch channel state change
+#define IQS5XX_EVENT_PROX             0x80    // Proximity channel state change
+
 #define IQS5XX_SYS_GESTURE_EVENTS_0   0x0D
 #define IQS5XX_SYS_GESTURE_EVENTS_1   0x0E
 
+// Gesture enable registers: same bit layout as GESTURE_EVENTS_0/1
+#define IQS5XX_REG_SINGLE_FINGER_GESTURES 0x06B7
+#define IQS5XX_REG_MULTI_FINGER_GESTURES  0x06B8
+#define IQS5XX_SINGLE_FINGER_GESTURES_ALL 0x3F    // Tap, press and hold, 4 swipes
+#define IQS5XX_MULTI_FINGER_GESTURES_ALL  0x07    // Two-finger tap, scroll, zoom
+
 #define IQS5XX_REG_NUM_FINGERS        0x0011
+
+// Configuration registers mirrored in the shadow cache: System Control 0/1
+// and the report rate, timeout and System Configuration registers
+#define IQS5XX_SHADOW_CNT_START       IQS5XX_REG_SYS_CNT0
+#define IQS5XX_SHADOW_CNT_LENGTH      (IQS5XX_REG_SYS_CNT1 - IQS5XX_SHADOW_CNT_START + 1)
+#define IQS5XX_SHADOW_CFG_START       IQS5XX_REG_ACTIVE_REPORT_RATE
+#define IQS5XX_SHADOW_CFG_LENGTH      (IQS5XX_REG_SYS_CFG1 - IQS5XX_SHADOW_CFG_START + 1)
+#define IQS5XX_SHADOW_SIZE            (IQS5XX_SHADOW_CNT_LENGTH + IQS5XX_SHADOW_CFG_LENGTH)
+
+// Contiguous XY data block read by readTouchData() in a single burst:
+// GESTURE_EVENTS_0 (0x0D) up to and including the finger 1 area register
+#define IQS5XX_XY_BLOCK_START         IQS5XX_SYS_GESTURE_EVENTS_0
+#define IQS5XX_XY_BLOCK_LENGTH        (IQS5XX_REG_AREA - IQS5XX_XY_BLOCK_START + 1)
+// Byte of register `reg` inside a buffer filled from IQS5XX_XY_BLOCK_START
+#define IQS5XX_XY_BYTE(block, reg)    ((block)[(reg) - IQS5XX_XY_BLOCK_START])
+
+// Per-finger slots follow the relative coordinates: finger 1 starts at
+// IQS5XX_REG_TOUCH_X and each slot is X(2), Y(2), strength(2), area(1)
+#define IQS5XX_MAX_FINGERS            5
+#define IQS5XX_FINGER_STRIDE          7
+#define IQS5XX_FINGER_X               0
+#define IQS5XX_FINGER_Y               2
+#define IQS5XX_FINGER_STRENGTH        4
+#define IQS5XX_FINGER_AREA            6
+// Length of a block read from IQS5XX_XY_BLOCK_START covering `n` finger slots
+#define IQS5XX_XY_BLOCK_LENGTH_FOR(n) (IQS5XX_REG_TOUCH_X - IQS5XX_XY_BLOCK_START + (n) * IQS5XX_FINGER_STRIDE)
+
 // Touch states
 enum TouchState {
   NO_TOUCH = 0,
@@ -76,11 +172,40 @@ enum TouchState {
   MULTI_TOUCH = 2
 };
 
+// Result of a bounded or non-blocking frame read
+enum FrameStatus {
+  FRAME_READY = 0,     // A frame was read and decoded
+  FRAME_NOT_READY,     // RDY did not assert within the time budget, nothing was read
+  FRAME_BUS_ERROR,     // The device did not respond on the bus
+  FRAME_DEVICE_RESET   // A frame was read but the device reset since begin(); reinitialize
+};
+
+// Outcome of a register access
+enum RegisterStatus {
+  REGISTER_OK = 0,       // The value was read from the device (or the shadow)
+  REGISTER_NO_BUS,       // begin() was not called or the arguments are invalid
+  REGISTER_NACK,         // The device did not acknowledge (address or read phase)
+  REGISTER_SHORT_READ    // The device returned fewer bytes than requested
+};
+
+// Register value together with the status of the access that produced it,
+// so a bus error can be told apart from a register that really reads 0
+template <typename T>
+struct RegisterResult {
+  T value;                // Register value, 0 unless status is REGISTER_OK
+  RegisterStatus status;
+
+  bool ok() const { return status == REGISTER_OK; }
+};
+
+// Pass as timeout to wait for RDY without a time limit
+#define IQS5XX_WAIT_FOREVER 0xFFFFFFFFUL
+
 // Touch data structure
 struct TouchData {
   uint16_t x;
   uint16_t y;
-  uint8_t touchStrength;
+  uint16_t touchStrength;
   uint8_t area;
   uint8_t numFingers;
   TouchState state;
@@ -93,19 +218,78 @@ struct TouchData {
   bool zoom;         //bit 2 GESTURE_EVENTS_1
   bool scroll;       //bit 1 GESTURE_EVENTS_1
   bool twoFingerTap; //bit 0 GESTURE_EVENTS_1
+  uint8_t events;    //IQS5XX_EVENT_* classes present in this frame
+  int16_t relX;      //Movement of finger 1 since the last report (0x0012)
+  int16_t relY;      //(0x0014)
+};
+
+// Bus traffic counters (see getBusStats())
+struct BusStats {
+  uint32_t transactions;  // Addressed register accesses (address write + optional read)
+  uint32_t bytesWritten;  // Bytes written on the bus, including register address bytes
+  uint32_t bytesRead;     // Bytes read back from the device
+};
+
+// Timestamps of the begin() phases, in microseconds since begin() was
+// called. A skipped phase repeats the previous timestamp.
+struct StartupTiming {
+  uint32_t probeUs;       // Address probe answered (or NACKed)
+  uint32_t wakeUs;        // Device awake
+  uint32_t identifyUs;    // Product number checked
+  uint32_t configureUs;   // Profile, manual control and reset acknowledge written
+  uint32_t firstReadyUs;  // First frame read after begin() (0 until then)
+  bool warmStart;         // Identification and configuration were skipped
+};
+
+// Identity of a configured device, persisted by the application across MCU
+// restarts (e.g. RTC memory or NVS) to allow a warm start
+struct DeviceFingerprint {
+  uint16_t productNumber;
+  uint16_t profileHash;   // Hash of the configuration profile passed to begin()
+  uint8_t address;
+  bool valid;
+};
+
+// Multi-touch frame with all finger slots, stored as struct-of-arrays so
+// coordinates can be iterated without touching strength/area bytes.
+// Only the first numFingers entries of each array are valid; the rest are 0.
+struct MultiTouchFrame {
+  uint8_t numFingers;
+  uint8_t gestureEvents0;
+  uint8_t gestureEvents1;
+  uint8_t systemInfo0;
+  uint8_t systemInfo1;
+  int16_t relX;
+  int16_t relY;
+  uint16_t x[IQS5XX_MAX_FINGERS];
+  uint16_t y[IQS5XX_MAX_FINGERS];
+  uint16_t strength[IQS5XX_MAX_FINGERS];
+  uint8_t area[IQS5XX_MAX_FINGERS];
+  uint8_t events;     // IQS5XX_EVENT_* classes present in this frame
 };
 
 /**
- * @class IQS5XX_B000_Trackpad
+ * @class IQS5XX_B000_TrackpadT
  * @brief Main class for interfacing with the IQS5XX-B000 trackpad
+ *
+ * Use it through IQS5XX_B000_Trackpad, or IQS5XX_InstrumentedTrackpad to
+ * record stats. The policy is an empty base without instrumentation, so it
+ * adds no bytes to the object and its hooks compile away.
+ * @tparam StatsPolicy IQS5XX_NullStats or IQS5XX_StatsRecorder
  */
-class IQS5XX_B000_Trackpad {
+template <class StatsPolicy>
+class IQS5XX_B000_TrackpadT : private StatsPolicy {
   public:
     /**
      * @brief Constructor for IQS5XX_B000_Trackpad
      * @param address I2C address of the device (default: IQS5XX_DEFAULT_ADDRESS)
      */
-    IQS5XX_B000_Trackpad(uint8_t readyPin, uint8_t address = IQS5XX_DEFAULT_ADDRESS);
+    IQS5XX_B000_TrackpadT(uint8_t readyPin, uint8_t address = IQS5XX_DEFAULT_ADDRESS);
+
+    /**
+     * @brief Destructor, detaches the RDY interrupt if interrupt mode is on
+     */
+    ~IQS5XX_B000_TrackpadT();
     
     /**
      * @brief Initialize the trackpad
@@ -113,6 +297,50 @@ class IQS5XX_B000_Trackpad {
      * @return true if initialization successful, false otherwise
      */
     bool begin(TwoWire &wire = Wire);
+
+    /**
+     * @brief Initialize the trackpad and apply a configuration profile
+     *
+     * The profile is written right after the device is identified, before
+     * manual control is enabled, so a profile that already sets
+     * IQS5XX_SYS_CFG0_MANUAL_CONTROL costs no extra transaction.
+     * @param wire Reference to Wire interface
+     * @param profile Coalesced profile, see IQS5XX_ConfigProfile.h
+     * @return true if initialization successful, false otherwise
+     */
+    bool begin(TwoWire &wire, const IQS5XX_ConfigBursts &profile);
+
+    /**
+     * @brief Allow the next begin() to skip identification and configuration
+     *
+     * The fast path is taken when the fingerprint matches the address and
+     * profile passed to begin() and the device has not reset since it was
+     * configured (SHOW_RESET clear), which costs a single register read.
+     * Otherwise begin() falls back to the full startup.
+     * @param fingerprint Fingerprint saved from getFingerprint() after a previous begin()
+     */
+    void setWarmStart(const DeviceFingerprint &fingerprint);
+
+    /**
+     * @brief Fingerprint of the device configured by the last successful begin()
+     * @return Fingerprint to persist for setWarmStart(); valid is false before begin()
+     */
+    DeviceFingerprint getFingerprint() const;
+
+    /**
+     * @brief Phase timestamps of the last begin()
+     * @return Reference to the timing of the last startup
+     */
+    const StartupTiming& getStartupTiming() const;
+
+    /**
+     * @brief Write a coalesced configuration profile, one transaction per burst
+     *
+     * Bursts whose bytes all match the configuration shadow are skipped.
+     * @param profile Coalesced profile, see IQS5XX_ConfigProfile.h
+     * @return true if every burst was written, false otherwise
+     */
+    bool applyConfig(const IQS5XX_ConfigBursts &profile);
     
     /**
      * @brief Check if device is connected and responding
@@ -125,6 +353,28 @@ class IQS5XX_B000_Trackpad {
      * @return Product number, or 0 if read failed
      */
     uint16_t getProductNumber();
+
+    /**
+     * @brief Read product number from device
+     * @return Product number and status of the read
+     */
+    RegisterResult<uint16_t> tryGetProductNumber();
+
+    /**
+     * @brief Read an 8-bit register at a 16-bit address
+     *
+     * Shadowed configuration registers are served from the shadow.
+     * @param reg 16-bit register address
+     * @return Register value and status of the read
+     */
+    RegisterResult<uint8_t> tryReadRegister8(uint16_t reg);
+
+    /**
+     * @brief Read a big-endian 16-bit register at a 16-bit address
+     * @param reg 16-bit register address
+     * @return Register value and status of the read
+     */
+    RegisterResult<uint16_t> tryReadRegister16(uint16_t reg);
     
     /**
      * @brief Read version information from device
@@ -146,44 +396,140 @@ class IQS5XX_B000_Trackpad {
     
     /**
      * @brief Read touch data from the trackpad
+     *
+     * Presence is decided by the finger count only, so a finger on the
+     * left or top edge (coordinate 0) is reported like any other.
      * @param touchData Reference to TouchData structure to fill
-     * @return true if read successful, false otherwise
+     * @return true if a finger was read, false on bus error or when no
+     *         finger is present (touchData.state is NO_TOUCH)
      */
     bool readTouchData(TouchData &touchData);
+
+    /**
+     * @brief Read all finger slots from the trackpad
+     *
+     * Waits for RDY like readTouchData(). Only the slots of fingers that are
+     * actually present are read off the bus: the burst length follows the
+     * finger count of the previous frame and a second read fetches the
+     * remaining slots only when more fingers landed.
+     * @param frame Reference to MultiTouchFrame structure to fill
+     * @return true if read successful, false otherwise
+     */
+    bool readMultiTouch(MultiTouchFrame &frame);
+
+    /**
+     * @brief Read touch data, waiting at most timeoutUs for RDY
+     *
+     * Unlike readTouchData() this never blocks longer than the budget and
+     * reports frames without a finger as FRAME_READY with state NO_TOUCH.
+     * @param touchData Reference to TouchData structure to fill
+     * @param timeoutUs Maximum time to wait for RDY in microseconds
+     *                  (0 = check once, IQS5XX_WAIT_FOREVER = no limit)
+     * @return FrameStatus of the attempt
+     */
+    FrameStatus tryReadTouchData(TouchData &touchData, uint32_t timeoutUs);
+
+    /**
+     * @brief Read all finger slots, waiting at most timeoutUs for RDY
+     * @param frame Reference to MultiTouchFrame structure to fill
+     * @param timeoutUs Maximum time to wait for RDY in microseconds
+     * @return FrameStatus of the attempt
+     */
+    FrameStatus tryReadMultiTouch(MultiTouchFrame &frame, uint32_t timeoutUs);
+
+    /**
+     * @brief Non-blocking frame read, returns immediately if RDY is not asserted
+     *
+     * Each communication window is read once: while RDY stays LOW after a
+     * read (until the I2C timeout, or endCommunicationWindow()) this
+     * returns FRAME_NOT_READY.
+     * @param touchData Reference to TouchData structure to fill
+     * @return FrameStatus of the attempt
+     */
+    FrameStatus poll(TouchData &touchData);
+
+    /**
+     * @brief Acknowledge a device reset (clears SHOW_RESET in System Info 0),
+     * keeping the MODE_SELECT power mode in System Control 0
+     * @return true if successful, false otherwise
+     */
+    bool acknowledgeReset();
     
+    /**
+     * @brief Acquire a new frame into the touch snapshot
+     *
+     * Waits for RDY like readTouchData() and stores the frame, with or
+     * without a finger present, as the snapshot returned by the cached
+     * getters below. Every acquired frame increments the frame sequence.
+     * @return true if a frame was read, false on bus error
+     */
+    bool update();
+
+    /**
+     * @brief Get the touch snapshot from the most recently acquired frame
+     * @return Reference to the last TouchData (no bus access)
+     */
+    const TouchData& getLastTouchData() const;
+
+    /**
+     * @brief Get the sequence number of the most recently acquired frame
+     *
+     * Incremented by update(), readTouchData(), poll() and service() once
+     * per communication window, i.e. per new frame from the device. Use it
+     * to detect whether the snapshot changed.
+     * @return Frame sequence number
+     */
+    uint32_t getFrameSequence() const;
+
     /**
      * @brief Check if there is currently a touch detected
-     * @return TouchState enum value
+     * @return TouchState of the last acquired frame (no bus access)
      */
-    TouchState getTouchState();
+    TouchState getTouchState() const;
     
     /**
      * @brief Get X coordinate of touch (if available)
-     * @return X coordinate (0-65535), or 0 if no touch
+     * @return X coordinate of the last acquired frame (0-65535), or 0 if no touch
      */
-    uint16_t getTouchX();
+    uint16_t getTouchX() const;
     
     /**
      * @brief Get Y coordinate of touch (if available)  
-     * @return Y coordinate (0-65535), or 0 if no touch
+     * @return Y coordinate of the last acquired frame (0-65535), or 0 if no touch
      */
-    uint16_t getTouchY();
+    uint16_t getTouchY() const;
     
     /**
      * @brief Get touch strength
-     * @return Touch strength value, or 0 if no touch
+     * @return Touch strength of the last acquired frame, or 0 if no touch
      */
-    uint8_t getTouchStrength();
+    uint16_t getTouchStrength() const;
     
     /**
      * @brief Get touch area
-     * @return Touch area value, or 0 if no touch
+     * @return Touch area of the last acquired frame, or 0 if no touch
      */
-    uint8_t getTouchArea();
+    uint8_t getTouchArea() const;
     
+    /**
+     * @brief Forget all cached configuration register values
+     *
+     * Configuration registers (System Control 0/1, report rates, timeouts,
+     * System Configuration 0/1) are cached when read or written, so
+     * unchanged writes and repeated reads do not touch the bus. The cache
+     * is dropped automatically on begin(), softReset() and whenever a
+     * device reset is observed; call this if the device may have been
+     * reconfigured behind the library's back.
+     */
+    void invalidateShadow();
+
     /**
      * @brief Perform soft reset of the device
-     * @return true if reset successful, false otherwise
+     *
+     * Sets RESET in System Control 1. The device restarts with its power-on
+     * configuration and reports SHOW_RESET until acknowledged, so call
+     * begin() again afterwards.
+     * @return true if the reset command was written, false otherwise
      */
     bool softReset();
     
@@ -200,8 +546,37 @@ class IQS5XX_B000_Trackpad {
     bool enableManualControl();
     
     /**
-     * @brief Check if device is ready for data (RDY pin low)
-     * @return true if ready, false otherwise
+     * @brief Configure event mode (System Configuration 1)
+     *
+     * With event mode enabled RDY only asserts when one of the selected
+     * event classes occurred, so an idle pad generates no bus traffic.
+     * Which classes triggered a frame is decoded into TouchData::events and
+     * MultiTouchFrame::events.
+     * @param events OR of IQS5XX_EVENT_TP, IQS5XX_EVENT_GESTURE,
+     *               IQS5XX_EVENT_REATI, ...; 0 disables event mode
+     * @return true if successful, false otherwise
+     */
+    bool setEventMode(uint8_t events);
+
+    /**
+     * @brief Enable or disable the on-chip gesture engine
+     *
+     * Writes both gesture enable registers in one transaction. Pass 0, 0
+     * when gestures are recognized on the host (IQS5XX_GestureEngine);
+     * the device then skips gesture processing and never reports gesture
+     * bits. Also drop IQS5XX_EVENT_GESTURE from setEventMode().
+     * @param singleFinger Single-finger gestures (bits as GESTURE_EVENTS_0)
+     * @param multiFinger Multi-finger gestures (bits as GESTURE_EVENTS_1)
+     * @return true if successful, false otherwise
+     */
+    bool setDeviceGestures(uint8_t singleFinger, uint8_t multiFinger);
+
+    /**
+     * @brief Check if a new frame is ready (RDY pin low)
+     *
+     * A window whose frame has already been read does not count, even
+     * though RDY stays LOW until the I2C timeout expires.
+     * @return true if a new frame can be read, false otherwise
      */
     bool isReadyForData();
 
@@ -211,6 +586,26 @@ class IQS5XX_B000_Trackpad {
      */
     bool increaseSpeed();
 
+    /**
+     * @brief End the current communication window
+     *
+     * Writes to IQS5XX_REG_END_COMM_WINDOW so the device releases RDY and
+     * starts the next conversion right away instead of waiting for the I2C
+     * timeout to expire.
+     * @return true if successful, false otherwise
+     */
+    bool endCommunicationWindow();
+
+    /**
+     * @brief Close the communication window after every frame read
+     *
+     * When enabled, readTouchData(), readMultiTouch(), update() and service()
+     * call endCommunicationWindow() right after the burst read, so the report
+     * rate is no longer stretched by the I2C timeout. Disabled by default.
+     * @param enable true to end the window after each frame
+     */
+    void setEndWindowAfterRead(bool enable);
+
     /**
      * @brief Write 16-bit value to 16-bit register address
      * @param reg 16-bit register address
@@ -235,48 +630,340 @@ class IQS5XX_B000_Trackpad {
      */
     bool writeRegister8_16bit(uint16_t reg, uint8_t value);
 
+    /**
+     * @brief Get the bus traffic counters accumulated since the last reset
+     * @return Copy of the current counters
+     */
+    BusStats getBusStats() const;
+
+    /**
+     * @brief Reset the bus traffic counters to zero
+     */
+    void resetBusStats();
+
+    /**
+     * @brief Detailed instrumentation: failures, timeouts and latency histograms
+     *
+     * Only recorded by IQS5XX_InstrumentedTrackpad; IQS5XX_B000_Trackpad
+     * compiles the hooks away and returns all zeros.
+     * @return Copy of the current stats
+     */
+    TrackpadStats getStats() const;
+
+    /**
+     * @brief Reset the instrumentation stats to zero
+     */
+    void resetStats();
+
+    /**
+     * @brief Dump the instrumentation stats in the serial dump format
+     * @param out Serial or any other Print
+     */
+    void printStats(Print &out) const;
+
+    /**
+     * @brief Switch to interrupt-driven acquisition
+     *
+     * Attaches a falling-edge interrupt to the RDY pin. The interrupt only
+     * marks a frame as pending; call service() from the loop to read it and
+     * popFrame() to drain decoded frames without blocking. Only one
+     * trackpad instance can use interrupt mode at a time.
+     * @return true if the interrupt was attached, false otherwise
+     */
+    bool beginInterruptMode();
+
+    /**
+     * @brief Detach the RDY interrupt and discard any queued frames
+     */
+    void endInterruptMode();
+
+    /**
+     * @brief Read a pending frame (if any) and append it to the frame queue
+     *
+     * Never waits for RDY. Frames are queued whether or not a finger is
+     * present, so lift-off is visible to the consumer as a NO_TOUCH frame.
+     * @return true if a frame was read and queued, false otherwise
+     */
+    bool service();
+
+    /**
+     * @brief Route frame reads through a non-blocking I2C backend
+     *
+     * With a backend, pollAsync() and service() submit the XY block burst
+     * read and return at once; the frame is decoded by a later call after
+     * the backend reports completion. Configuration accesses keep using
+     * Wire. The backend must outlive the trackpad or be removed first.
+     *
+     * The backend in use holds pointers into the trackpad while a transfer
+     * is in flight, so it cannot be replaced or removed until the transfer
+     * has completed: the switch is refused and has to be retried (keep
+     * calling pollAsync(), or let the transfer finish, in between).
+     * @param backend Backend to use, or nullptr for synchronous Wire reads
+     * @return true if switched, false while a transfer is in flight
+     */
+    bool setI2CBackend(IQS5XX_I2CBackend* backend);
+
+    /**
+     * @brief Advance the non-blocking frame read state machine
+     *
+     * Never waits for RDY or for the bus. When a new window opens (or a
+     * frame is pending in interrupt mode) the burst read is submitted; once
+     * it completes the frame is decoded into touchData. Like poll(), each
+     * window is read once. If the backend rejects the submission the frame
+     * stays pending for the next call. Without a backend this is the same
+     * as poll().
+     * @param touchData Reference to TouchData structure to fill
+     * @return FRAME_READY or FRAME_DEVICE_RESET when a frame was decoded,
+     *         FRAME_NOT_READY while waiting for RDY or the transfer,
+     *         FRAME_BUS_ERROR if the transfer failed or was rejected
+     */
+    FrameStatus pollAsync(TouchData &touchData);
+
+    /**
+     * @brief Take the oldest decoded frame from the frame queue
+     * @param touchData Reference to TouchData structure to fill
+     * @return true if a frame was available, false if the queue is empty
+     */
+    bool popFrame(TouchData &touchData);
+
+    /**
+     * @brief Number of decoded frames waiting in the frame queue
+     * @return Frame count
+     */
+    uint8_t framesAvailable() const;
+
+    /**
+     * @brief Number of frames dropped because the frame queue was full
+     * @return Dropped frame count
+     */
+    uint32_t getDroppedFrames() const;
+
   private:
     uint8_t _readyPin;
     uint8_t _address;
     TwoWire* _wire;
     TouchData _lastTouchData;
-    
+    uint32_t _frameSequence;
+    BusStats _busStats;
+    IQS5XX_FrameQueue<TouchData, IQS5XX_FRAME_QUEUE_SIZE> _frameQueue;
+    volatile bool _framePending;
+    bool _windowConsumed;         // The frame of the open window was read
+    uint32_t _lastAccessUs;       // micros() after the last bus transaction
+    bool _interruptMode;
+    uint8_t _expectedFingers;
+    bool _endWindowAfterRead;
+    uint8_t _lastNumFingers;
+
+    // Startup timing and warm start
+    StartupTiming _startupTiming;
+    uint32_t _startupStartUs;
+    bool _awaitFirstFrame;
+    DeviceFingerprint _fingerprint;
+    DeviceFingerprint _warmStart;
+
     /**
-     * @brief Read 8-bit value from register
-     * @param reg Register address
-     * @return Register value, or 0 if read failed
+     * @brief Hash identifying a configuration profile
+     * @param profile Coalesced profile
+     * @return 16-bit FNV-1a style hash of the burst addresses and data
      */
-    uint8_t readRegister8(uint8_t reg);
-    
+    static uint16_t hashProfile(const IQS5XX_ConfigBursts &profile);
+
     /**
-     * @brief Read 8-bit value from 16-bit register address
+     * @brief Record the first frame after begin() in the startup timing
+     */
+    void noteFrame();
+
+    // Shadow of the configuration registers, one valid bit per byte
+    uint8_t _shadow[IQS5XX_SHADOW_SIZE];
+    uint32_t _shadowValid;
+
+    /**
+     * @brief Position of a register in the shadow
      * @param reg 16-bit register address
-     * @return Register value, or 0 if read failed
+     * @return Index into _shadow, or -1 if the register is not shadowed
      */
-    uint8_t readRegister8_16bit(uint16_t reg);
+    int8_t shadowIndex(uint16_t reg) const;
+
+    /**
+     * @brief Serve a read from the shadow
+     * @param reg 16-bit register address
+     * @param data Buffer to fill
+     * @param length Number of bytes
+     * @return true if every byte was cached, false otherwise
+     */
+    bool shadowRead(uint16_t reg, uint8_t* data, uint8_t length) const;
+
+    /**
+     * @brief Whether writing data would leave the device unchanged
+     * @param reg 16-bit register address
+     * @param data Bytes to write
+     * @param length Number of bytes
+     * @return true if every byte is cached with the same value and no command bit is set
+     */
+    bool shadowMatches(uint16_t reg, const uint8_t* data, uint8_t length) const;
+
+    /**
+     * @brief Record values read from or written to the device
+     * @param reg 16-bit register address
+     * @param data Bytes to store, or nullptr to invalidate them
+     * @param length Number of bytes
+     */
+    void shadowStore(uint16_t reg, const uint8_t* data, uint8_t length);
+
+    // Non-blocking frame reads (setI2CBackend())
+    enum AsyncState { ASYNC_IDLE, ASYNC_READ, ASYNC_END_WINDOW };
+    IQS5XX_I2CBackend* _backend;
+    AsyncState _asyncState;
+    IQS5XX_I2CTransfer _transfer;
+    uint8_t _asyncBlock[IQS5XX_XY_BLOCK_LENGTH];
+
+    /**
+     * @brief Submit a register read or write on the I2C backend
+     * @param reg 16-bit register address
+     * @param data Bytes to write after the address (nullptr for a read)
+     * @param writeLength Number of bytes in data
+     * @param rx Read destination (nullptr for a write)
+     * @param readLength Number of bytes to read
+     * @return true if the backend accepted the transfer, false otherwise
+     */
+    bool submitTransfer(uint16_t reg, const uint8_t* data, uint8_t writeLength, uint8_t* rx, uint8_t readLength);
+
+    /**
+     * @brief Work out which event classes a frame carries
+     * @param gesture0 GESTURE_EVENTS_0 register
+     * @param gesture1 GESTURE_EVENTS_1 register
+     * @param systemInfo0 System Info 0 register
+     * @param numFingers Number of fingers in the frame
+     * @return OR of IQS5XX_EVENT_* bits
+     */
+    uint8_t decodeEvents(uint8_t gesture0, uint8_t gesture1, uint8_t systemInfo0, uint8_t numFingers);
+
+    // Instance served by the RDY interrupt handler
+    static IQS5XX_B000_TrackpadT* _interruptInstance;
+
+    /**
+     * @brief RDY falling-edge interrupt handler, marks a frame as pending
+     */
+    static void IRAM_ATTR onReadyInterrupt();
+
+    /**
+     * @brief Burst-read and decode one frame without waiting for RDY
+     *
+     * On success the frame also becomes the touch snapshot.
+     * @param touchData Reference to TouchData structure to fill
+     * @return FRAME_READY, FRAME_DEVICE_RESET or FRAME_BUS_ERROR
+     */
+    FrameStatus acquireTouchData(TouchData &touchData);
+
+    /**
+     * @brief Decode a burst-read XY data block into touchData and the snapshot
+     * @param block IQS5XX_XY_BLOCK_LENGTH bytes starting at IQS5XX_XY_BLOCK_START
+     * @param touchData Reference to TouchData structure to fill
+     * @param newWindow The block is the first read of its window (advances the frame sequence)
+     * @return FRAME_READY or FRAME_DEVICE_RESET
+     */
+    FrameStatus decodeTouchData(const uint8_t* block, TouchData &touchData, bool newWindow);
+
+    /**
+     * @brief Burst-read and decode all present finger slots without waiting for RDY
+     * @param frame Reference to MultiTouchFrame structure to fill
+     * @return FRAME_READY, FRAME_DEVICE_RESET or FRAME_BUS_ERROR
+     */
+    FrameStatus acquireMultiTouch(MultiTouchFrame &frame);
+
+    /**
+     * @brief Whether RDY is LOW for a window that has not been read yet
+     * @return true if a new frame can be read
+     */
+    bool windowReady();
+
+    /**
+     * @brief Mark the open window as read
+     * @return true if it had not been read before
+     */
+    bool consumeWindow();
+
+    /**
+     * @brief How long a window stays open after the last access
+     * @return The cached I2C timeout, or the power-on default, in microseconds
+     */
+    uint32_t windowTimeoutUs() const;
+
+    /**
+     * @brief Wait until a new window opens or the time budget is spent
+     *
+     * A window that was already read only counts again after RDY went HIGH
+     * or the I2C timeout expired.
+     * @param timeoutUs Budget in microseconds (0 = check once, IQS5XX_WAIT_FOREVER = no limit)
+     * @return true if a new frame can be read, false on timeout
+     */
+    bool waitForReady(uint32_t timeoutUs);
     
     /**
-     * @brief Read 16-bit value from register
+     * @brief Read 8-bit value from register
      * @param reg Register address
-     * @return Register value, or 0 if read failed
+     * @return Register value and status of the read
      */
-    uint16_t readRegister16(uint8_t reg);
+    RegisterResult<uint8_t> readRegister8(uint8_t reg);
     
     /**
-     * @brief Read 16-bit value from 16-bit register address
-     * @param reg 16-bit register address
-     * @return Register value, or 0 if read failed
+     * @brief Read 16-bit value from register
+     * @param reg Register address
+     * @return Register value and status of the read
      */
-    uint16_t readRegister16_16bit(uint16_t reg);
+    RegisterResult<uint16_t> readRegister16(uint8_t reg);
     
     /**
      * @brief Read multiple bytes from device
      * @param reg Starting register address
      * @param buffer Buffer to store read data
      * @param length Number of bytes to read
-     * @return true if read successful, false otherwise
+     * @return REGISTER_OK if every byte was read, the failure otherwise
      */
-    bool readBytes(uint8_t reg, uint8_t* buffer, uint8_t length);
+    RegisterStatus readBytes(uint8_t reg, uint8_t* buffer, uint8_t length);
+
+    /**
+     * @brief Read multiple bytes starting at a 16-bit register address in one burst
+     * @param reg 16-bit starting register address
+     * @param buffer Buffer to store read data
+     * @param length Number of bytes to read
+     * @return REGISTER_OK if every byte was read, the failure otherwise
+     */
+    RegisterStatus readBytes16(uint16_t reg, uint8_t* buffer, uint8_t length);
+
+    /**
+     * @brief Write multiple bytes starting at a 16-bit register address in one burst
+     * @param reg 16-bit starting register address
+     * @param data Bytes to write
+     * @param length Number of bytes (at most IQS5XX_CONFIG_MAX_BURST)
+     * @return true if write successful, false otherwise
+     */
+    bool writeBytes16(uint16_t reg, const uint8_t* data, uint8_t length);
+
+    /**
+     * @brief Account for one addressed bus transaction in the bus counters
+     * @param written Bytes written, including register address bytes
+     * @param read Bytes read back
+     * @param ok false if the access was not acknowledged or came back short
+     */
+    void countTransaction(uint8_t written, uint8_t read, bool ok = true);
+
+    /**
+     * @brief Start an addressed access (beginTransmission) and its latency measurement
+     */
+    void startTransaction();
+
+    /**
+     * @brief The stats policy base
+     */
+    StatsPolicy& stats() { return *this; }
+    const StatsPolicy& stats() const { return *this; }
 };
 
+// Trackpad without instrumentation
+typedef IQS5XX_B000_TrackpadT<IQS5XX_NullStats> IQS5XX_B000_Trackpad;
+
+// Trackpad that records failures, timeouts and latency histograms (getStats())
+typedef IQS5XX_B000_TrackpadT<IQS5XX_StatsRecorder> IQS5XX_InstrumentedTrackpad;
+
 #endif // IQS5XX_B000_TRACKPAD_H
\ No newline at end of file
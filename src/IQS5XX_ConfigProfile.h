@@ -0,0 +1,147 @@
+/**
+ * @file IQS5XX_ConfigProfile.h
+ * @brief Configuration profiles coalesced into burst writes at compile time
+ * @author lemio
+ *
+ * A profile is a table of (register, value) byte pairs. With C++14 or
+ * newer, IQS5XX_makeConfigProfile() sorts the table, drops overridden
+ * entries (the last one for a register wins) and merges consecutive
+ * registers into as few burst writes as possible, all at compile time:
+ *
+ *   constexpr IQS5XX_RegisterValue kTable[] = {
+ *     IQS5XX_CONFIG16(IQS5XX_REG_ACTIVE_REPORT_RATE, 5),
+ *     IQS5XX_CONFIG8(IQS5XX_REG_I2C_TIMEOUT, 5),
+ *   };
+ *   constexpr auto kProfile = IQS5XX_makeConfigProfile(kTable);
+ *   trackpad.begin(Wire, kProfile.bursts());
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_CONFIG_PROFILE_H
+#define IQS5XX_CONFIG_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest number of data bytes in one burst write (Wire buffer minus the
+// two register address bytes)
+#ifndef IQS5XX_CONFIG_MAX_BURST
+#define IQS5XX_CONFIG_MAX_BURST 30
+#endif
+
+// Table entries for 8-bit and 16-bit (big-endian) registers
+#define IQS5XX_CONFIG8(reg, value)  {(uint16_t)(reg), (uint8_t)(value)}
+#define IQS5XX_CONFIG16(reg, value) {(uint16_t)(reg), (uint8_t)((value) >> 8)}, \
+                                    {(uint16_t)((reg) + 1), (uint8_t)((value) & 0xFF)}
+
+/**
+ * @brief One configuration byte
+ */
+struct IQS5XX_RegisterValue {
+  uint16_t reg;
+  uint8_t value;
+};
+
+/**
+ * @brief One burst write: `length` bytes from `data + offset` starting at `reg`
+ */
+struct IQS5XX_ConfigBurst {
+  uint16_t reg;
+  uint8_t offset;
+  uint8_t length;
+};
+
+/**
+ * @brief Coalesced profile as applied by IQS5XX_B000_Trackpad::applyConfig()
+ */
+struct IQS5XX_ConfigBursts {
+  const IQS5XX_ConfigBurst* bursts;
+  uint8_t count;
+  const uint8_t* data;
+};
+
+#if __cplusplus >= 201402L
+
+/**
+ * @class IQS5XX_ConfigProfile
+ * @brief Sorted, de-duplicated and coalesced register table
+ * @tparam N Number of table entries (upper bound for bytes and bursts)
+ */
+template <size_t N>
+class IQS5XX_ConfigProfile {
+    static_assert(N > 0 && N <= 255, "A profile holds between 1 and 255 register bytes");
+
+  public:
+    constexpr explicit IQS5XX_ConfigProfile(const IQS5XX_RegisterValue (&table)[N])
+        : _data(), _bursts(), _count(0), _length(0) {
+      // Give every element a value so the result stays a constant expression
+      for (size_t i = 0; i < N; i++) {
+        _data[i] = 0;
+        _bursts[i] = IQS5XX_ConfigBurst{0, 0, 0};
+      }
+
+      // Stable insertion sort, so the last entry for a register stays last
+      IQS5XX_RegisterValue sorted[N] = {};
+      for (size_t i = 0; i < N; i++) {
+        size_t j = i;
+        while (j > 0 && sorted[j - 1].reg > table[i].reg) {
+          sorted[j] = sorted[j - 1];
+          j--;
+        }
+        sorted[j] = table[i];
+      }
+
+      for (size_t i = 0; i < N; i++) {
+        if (i + 1 < N && sorted[i + 1].reg == sorted[i].reg) {
+          continue; // Overridden by a later entry
+        }
+        bool extend = _count > 0 &&
+                      sorted[i].reg == _bursts[_count - 1].reg + _bursts[_count - 1].length &&
+                      _bursts[_count - 1].length < IQS5XX_CONFIG_MAX_BURST;
+        if (!extend) {
+          _bursts[_count].reg = sorted[i].reg;
+          _bursts[_count].offset = _length;
+          _bursts[_count].length = 0;
+          _count++;
+        }
+        _data[_length++] = sorted[i].value;
+        _bursts[_count - 1].length++;
+      }
+    }
+
+    /**
+     * @brief Number of burst writes needed to apply the profile
+     */
+    constexpr uint8_t burstCount() const { return _count; }
+
+    /**
+     * @brief Number of distinct register bytes written
+     */
+    constexpr uint8_t size() const { return _length; }
+
+    /**
+     * @brief View passed to begin() / applyConfig(); the profile must outlive it
+     */
+    constexpr IQS5XX_ConfigBursts bursts() const { return {_bursts, _count, _data}; }
+
+  private:
+    uint8_t _data[N];
+    IQS5XX_ConfigBurst _bursts[N];
+    uint8_t _count;
+    uint8_t _length;
+};
+
+/**
+ * @brief Build a profile from a table, deducing its size
+ * @param table Array of IQS5XX_RegisterValue entries
+ * @return Coalesced profile (constexpr when the table is)
+ */
+template <size_t N>
+constexpr IQS5XX_ConfigProfile<N> IQS5XX_makeConfigProfile(const IQS5XX_RegisterValue (&table)[N]) {
+  return IQS5XX_ConfigProfile<N>(table);
+}
+
+#endif // __cplusplus >= 201402L
+
+#endif // IQS5XX_CONFIG_PROFILE_H
@@ -0,0 +1,158 @@
+/**
+ * @file IQS5XX_ContactTracker.cpp
+ * @brief Stable contact IDs on top of multi-touch frames
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_ContactTracker.h"
+
+#include <string.h>
+
+IQS5XX_ContactTracker::IQS5XX_ContactTracker() {
+  setMaxJump(IQS5XX_TRACKER_MAX_JUMP);
+  setSlotPenalty(IQS5XX_TRACKER_SLOT_PENALTY);
+  reset();
+}
+
+void IQS5XX_ContactTracker::reset() {
+  _nextId = 1;
+  _previousCount = 0;
+  memset(_previous, 0, sizeof(_previous));
+  memset(&_frame, 0, sizeof(_frame));
+}
+
+void IQS5XX_ContactTracker::setMaxJump(uint16_t counts) {
+  // Keeps dx^2 + dy^2 plus the penalty within 32 bits
+  if (counts > 32767) {
+    counts = 32767;
+  }
+  _maxJump = counts;
+  _maxJumpSquared = (uint32_t)counts * counts;
+}
+
+void IQS5XX_ContactTracker::setSlotPenalty(uint16_t counts) {
+  // With the clamp in setMaxJump(), distance + penalty cannot wrap
+  if (counts > 32767) {
+    counts = 32767;
+  }
+  _slotPenaltySquared = (uint32_t)counts * counts;
+}
+
+const Contact* IQS5XX_ContactTracker::find(uint8_t id) const {
+  for (uint8_t i = 0; i < _frame.count; i++) {
+    if (_frame.contacts[i].id == id) {
+      return &_frame.contacts[i];
+    }
+  }
+  return nullptr;
+}
+
+uint32_t IQS5XX_ContactTracker::cost(const Contact &previous, const MultiTouchFrame &frame, uint8_t slot) const {
+  int32_t dx = (int32_t)frame.x[slot] - previous.x;
+  int32_t dy = (int32_t)frame.y[slot] - previous.y;
+  if (dx < 0) dx = -dx;
+  if (dy < 0) dy = -dy;
+  if (dx > _maxJump || dy > _maxJump) {
+    return NO_MATCH;
+  }
+  uint32_t distance = (uint32_t)(dx * dx) + (uint32_t)(dy * dy);
+  if (distance > _maxJumpSquared) {
+    return NO_MATCH;
+  }
+  return (previous.slot == slot) ? distance : distance + _slotPenaltySquared;
+}
+
+uint8_t IQS5XX_ContactTracker::allocateId(const int8_t* match, uint8_t fingers) {
+  // IDs wrap after 255 touches; skip any still held by a matched contact
+  while (true) {
+    uint8_t id = _nextId;
+    _nextId = (_nextId == 255) ? 1 : _nextId + 1;
+    bool used = false;
+    for (uint8_t j = 0; j < fingers && !used; j++) {
+      used = match[j] >= 0 && _previous[match[j]].id == id;
+    }
+    if (!used) {
+      return id;
+    }
+  }
+}
+
+const ContactFrame& IQS5XX_ContactTracker::update(const MultiTouchFrame &frame) {
+  uint8_t fingers = (frame.numFingers > IQS5XX_MAX_FINGERS) ? IQS5XX_MAX_FINGERS : frame.numFingers;
+
+  for (uint8_t i = 0; i < _previousCount; i++) {
+    for (uint8_t j = 0; j < fingers; j++) {
+      _cost[i][j] = cost(_previous[i], frame, j);
+    }
+  }
+
+  // Greedy assignment, cheapest pair first; at most 5 passes over 25 cells
+  int8_t match[IQS5XX_MAX_FINGERS];     // Previous contact per slot, -1 = new
+  uint8_t previousMatched = 0;          // Bit per previous contact
+  uint8_t slotsMatched = 0;             // Bit per slot
+  for (uint8_t j = 0; j < fingers; j++) {
+    match[j] = -1;
+  }
+  uint8_t pairs = (_previousCount < fingers) ? _previousCount : fingers;
+  for (uint8_t n = 0; n < pairs; n++) {
+    uint32_t best = NO_MATCH;
+    uint8_t bestI = 0;
+    uint8_t bestJ = 0;
+    for (uint8_t i = 0; i < _previousCount; i++) {
+      if (previousMatched & (1 << i)) {
+        continue;
+      }
+      for (uint8_t j = 0; j < fingers; j++) {
+        if (!(slotsMatched & (1 << j)) && _cost[i][j] < best) {
+          best = _cost[i][j];
+          bestI = i;
+          bestJ = j;
+        }
+      }
+    }
+    if (best == NO_MATCH) {
+      break;
+    }
+    match[bestJ] = bestI;
+    previousMatched |= 1 << bestI;
+    slotsMatched |= 1 << bestJ;
+  }
+
+  // Fingers down, in slot order
+  uint8_t count = 0;
+  for (uint8_t j = 0; j < fingers; j++) {
+    Contact &contact = _frame.contacts[count++];
+    if (match[j] >= 0) {
+      const Contact &previous = _previous[match[j]];
+      contact.id = previous.id;
+      contact.phase = CONTACT_MOVE;
+      contact.frames = (previous.frames == 0xFFFF) ? 0xFFFF : previous.frames + 1;
+    } else {
+      contact.id = allocateId(match, fingers);
+      contact.phase = CONTACT_DOWN;
+      contact.frames = 0;
+    }
+    contact.slot = j;
+    contact.x = frame.x[j];
+    contact.y = frame.y[j];
+    contact.strength = frame.strength[j];
+    contact.area = frame.area[j];
+  }
+  _frame.active = count;
+
+  // Previous contacts left unmatched have lifted
+  for (uint8_t i = 0; i < _previousCount; i++) {
+    if (!(previousMatched & (1 << i))) {
+      Contact &contact = _frame.contacts[count++];
+      contact = _previous[i];
+      contact.phase = CONTACT_UP;
+    }
+  }
+  _frame.count = count;
+
+  memcpy(_previous, _frame.contacts, fingers * sizeof(Contact));
+  _previousCount = fingers;
+  return _frame;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file IQS5XX_ContactTracker.h
+ * @brief Stable contact IDs on top of multi-touch frames
+ * @author lemio
+ *
+ * The device reports up to five finger slots, but a slot is not a finger:
+ * when one finger lifts, the fingers behind it move up a slot. The tracker
+ * matches this frame's slots to last frame's contacts and keeps an ID per
+ * finger from touch-down to lift-off.
+ *
+ * Matching is nearest neighbour on a fixed 5x5 cost matrix: squared
+ * distance, plus a penalty when a contact changed slot, so the device's
+ * own slot order wins ties. Pairs are taken cheapest first; a finger that
+ * jumps farther than the gate is treated as a lift and a new touch. All
+ * state lives in the tracker object, nothing is allocated.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_CONTACT_TRACKER_H
+#define IQS5XX_CONTACT_TRACKER_H
+
+#include "IQS5XX_B000_Trackpad.h"
+
+// A frame lists the fingers present plus the ones that lifted since the last frame
+#define IQS5XX_MAX_CONTACTS          (2 * IQS5XX_MAX_FINGERS)
+
+// Contact ID 0 is never assigned
+#define IQS5XX_CONTACT_ID_NONE       0
+
+// Default gate: larger jumps between two frames start a new contact
+#define IQS5XX_TRACKER_MAX_JUMP      256
+// Default slot penalty, in position counts
+#define IQS5XX_TRACKER_SLOT_PENALTY  16
+
+enum ContactPhase {
+  CONTACT_DOWN = 0,   // First frame of this contact
+  CONTACT_MOVE,       // Still down, matched to the previous frame
+  CONTACT_UP          // Lifted; position is the last one reported
+};
+
+/**
+ * @brief One tracked finger
+ */
+struct Contact {
+  uint8_t id;         // Stable while the finger is down, 1-255
+  uint8_t slot;       // Device slot this frame (last slot for CONTACT_UP)
+  ContactPhase phase;
+  uint16_t x;
+  uint16_t y;
+  uint16_t strength;
+  uint8_t area;
+  uint16_t frames;    // Frames since touch-down (saturates)
+};
+
+/**
+ * @brief Contacts of one frame
+ *
+ * The first `active` entries are the fingers down, in slot order; the
+ * remaining `count - active` entries are contacts that lifted this frame.
+ */
+struct ContactFrame {
+  uint8_t count;
+  uint8_t active;
+  Contact contacts[IQS5XX_MAX_CONTACTS];
+};
+
+/**
+ * @class IQS5XX_ContactTracker
+ * @brief Assigns stable contact IDs to the finger slots of MultiTouchFrames
+ */
+class IQS5XX_ContactTracker {
+  public:
+    IQS5XX_ContactTracker();
+
+    /**
+     * @brief Track one frame
+     *
+     * Call with every frame read, including frames without fingers, so
+     * lift-offs are reported.
+     * @param frame Frame from readMultiTouch()
+     * @return Contacts of this frame, valid until the next update()
+     */
+    const ContactFrame& update(const MultiTouchFrame &frame);
+
+    /**
+     * @brief Contacts of the last update()
+     */
+    const ContactFrame& contacts() const { return _frame; }
+
+    /**
+     * @brief Look up a contact of the last update() by ID
+     * @param id Contact ID
+     * @return The contact, or nullptr if it is not in the last frame
+     */
+    const Contact* find(uint8_t id) const;
+
+    /**
+     * @brief Set the gate distance
+     * @param counts Largest per-axis movement between two frames that still
+     *               continues a contact (at most 32767)
+     */
+    void setMaxJump(uint16_t counts);
+
+    /**
+     * @brief Set the cost of a contact changing slot
+     * @param counts Penalty as a distance in position counts (at most 32767)
+     */
+    void setSlotPenalty(uint16_t counts);
+
+    /**
+     * @brief Forget all contacts (e.g. after a device reset)
+     */
+    void reset();
+
+  private:
+    static const uint32_t NO_MATCH = 0xFFFFFFFF;
+
+    uint16_t _maxJump;
+    uint32_t _maxJumpSquared;
+    uint32_t _slotPenaltySquared;
+    uint8_t _nextId;
+
+    Contact _previous[IQS5XX_MAX_FINGERS];
+    uint8_t _previousCount;
+    uint32_t _cost[IQS5XX_MAX_FINGERS][IQS5XX_MAX_FINGERS];
+    ContactFrame _frame;
+
+    uint32_t cost(const Contact &previous, const MultiTouchFrame &frame, uint8_t slot) const;
+    uint8_t allocateId(const int8_t* match, uint8_t fingers);
+};
+
+#endif // IQS5XX_CONTACT_TRACKER_H
@@ -0,0 +1,101 @@
+/**
+ * @file IQS5XX_EspIdfI2C.h
+ * @brief ESP-IDF asynchronous I2C master backend
+ * @author lemio
+ *
+ * Header-only so it is only compiled by sketches that include it. Needs
+ * ESP-IDF 5.2 or newer (Arduino-ESP32 3.x) and a bus created with
+ * trans_queue_depth > 0, which puts the i2c_master driver in asynchronous
+ * mode: transfers are queued to the controller and complete from the I2C
+ * interrupt while the CPU keeps running.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_ESP_IDF_I2C_H
+#define IQS5XX_ESP_IDF_I2C_H
+
+#if !defined(ESP_PLATFORM)
+#error "IQS5XX_EspIdfI2C.h requires ESP-IDF"
+#endif
+
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 2, 0)
+#error "IQS5XX_EspIdfI2C.h requires ESP-IDF 5.2 or newer"
+#endif
+
+#include <driver/i2c_master.h>
+#include "IQS5XX_AsyncI2C.h"
+
+/**
+ * @class IQS5XX_EspIdfI2C
+ * @brief Backend on the ESP-IDF i2c_master driver in asynchronous mode
+ *
+ * The device handle already carries the I2C address, so
+ * IQS5XX_I2CTransfer::address is ignored. Transfer callbacks run in
+ * interrupt context.
+ */
+class IQS5XX_EspIdfI2C : public IQS5XX_I2CBackend {
+  public:
+    /**
+     * @brief Constructor
+     * @param device Handle from i2c_master_bus_add_device() on a bus with trans_queue_depth > 0
+     */
+    explicit IQS5XX_EspIdfI2C(i2c_master_dev_handle_t device) : _device(device), _current(nullptr) {}
+
+    /**
+     * @brief Register the completion interrupt callback
+     * @return true if successful, false otherwise
+     */
+    bool begin() {
+      i2c_master_event_callbacks_t callbacks = {};
+      callbacks.on_trans_done = onTransferDone;
+      return i2c_master_register_event_callbacks(_device, &callbacks, this) == ESP_OK;
+    }
+
+    bool submit(IQS5XX_I2CTransfer &transfer) override {
+      if (_current != nullptr || transfer.txLength > IQS5XX_I2C_MAX_WRITE ||
+          (transfer.rxLength > 0 && transfer.rx == nullptr)) {
+        return false;
+      }
+      transfer.status = I2C_TRANSFER_BUSY;
+      _current = &transfer;
+
+      // Register address and read are joined by a repeated START
+      esp_err_t err;
+      if (transfer.txLength > 0 && transfer.rxLength > 0) {
+        err = i2c_master_transmit_receive(_device, transfer.tx, transfer.txLength,
+                                          transfer.rx, transfer.rxLength, -1);
+      } else if (transfer.rxLength > 0) {
+        err = i2c_master_receive(_device, transfer.rx, transfer.rxLength, -1);
+      } else {
+        err = i2c_master_transmit(_device, transfer.tx, transfer.txLength, -1);
+      }
+
+      if (err != ESP_OK) {
+        _current = nullptr;
+        complete(transfer, false);
+      }
+      return true;
+    }
+
+    bool busy() const override { return _current != nullptr; }
+
+  private:
+    i2c_master_dev_handle_t _device;
+    IQS5XX_I2CTransfer* volatile _current;
+
+    static bool IRAM_ATTR onTransferDone(i2c_master_dev_handle_t device,
+                                         const i2c_master_event_data_t* data, void* arg) {
+      (void)device;
+      IQS5XX_EspIdfI2C* self = static_cast<IQS5XX_EspIdfI2C*>(arg);
+      IQS5XX_I2CTransfer* transfer = self->_current;
+      self->_current = nullptr;
+      if (transfer != nullptr) {
+        complete(*transfer, data->event == I2C_EVENT_DONE);
+      }
+      return false; // No higher-priority task woken
+    }
+};
+
+#endif // IQS5XX_ESP_IDF_I2C_H
@@ -0,0 +1,188 @@
+/**
+ * @file IQS5XX_Filter.cpp
+ * @brief Fixed-point coordinate smoothing per tracked contact
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Filter.h"
+
+#include <string.h>
+
+namespace {
+
+// 2 * pi << 16
+const int64_t TWO_PI_Q16 = 411775;
+
+// Largest cutoff, keeps the smoothing factor product within 64 bits
+const uint32_t MAX_CUTOFF_Q8 = 0xFFFFFF;
+
+int32_t saturate32(int64_t value) {
+  if (value > INT32_MAX) return INT32_MAX;
+  if (value < INT32_MIN) return INT32_MIN;
+  return (int32_t)value;
+}
+
+// Exponential smoothing factor of a first-order low-pass, << 16:
+// alpha = r / (1 + r) = 1 - 1 / (1 + r) with r = 2 * pi * cutoff * dt
+int32_t smoothing(uint32_t cutoffQ8, uint32_t dtUs) {
+  if (cutoffQ8 > MAX_CUTOFF_Q8) {
+    cutoffQ8 = MAX_CUTOFF_Q8;
+  }
+  // r << 24 scaled by 1e6 (dt in microseconds) and >> 16; "one" is 1 on the same scale
+  const int64_t one = 256000000LL;
+  int64_t r = (TWO_PI_Q16 * cutoffQ8 * dtUs) >> 16;
+  return (int32_t)(65536 - (one << 16) / (r + one));
+}
+
+uint16_t toCounts(int32_t position) {
+  int32_t counts = (position + 128) >> 8;
+  if (counts < 0) return 0;
+  if (counts > 0xFFFF) return 0xFFFF;
+  return (uint16_t)counts;
+}
+
+} // namespace
+
+IQS5XX_ContactFilter::IQS5XX_ContactFilter() : _type(FILTER_NONE) {
+  const OneEuroParams oneEuro = IQS5XX_ONE_EURO_DEFAULT;
+  const AlphaBetaParams alphaBeta = IQS5XX_ALPHA_BETA_DEFAULT;
+  _oneEuro = oneEuro;
+  _alphaBeta = alphaBeta;
+  reset();
+}
+
+void IQS5XX_ContactFilter::setOneEuro(const OneEuroParams &params) {
+  _type = FILTER_ONE_EURO;
+  _oneEuro = params;
+  reset();
+}
+
+void IQS5XX_ContactFilter::setAlphaBeta(const AlphaBetaParams &params) {
+  _type = FILTER_ALPHA_BETA;
+  _alphaBeta = params;
+  reset();
+}
+
+void IQS5XX_ContactFilter::disable() {
+  _type = FILTER_NONE;
+  reset();
+}
+
+void IQS5XX_ContactFilter::reset() {
+  memset(_tracks, 0, sizeof(_tracks));
+  memset(&_frame, 0, sizeof(_frame));
+}
+
+const Contact* IQS5XX_ContactFilter::find(uint8_t id) const {
+  for (uint8_t i = 0; i < _frame.count; i++) {
+    if (_frame.contacts[i].id == id) {
+      return &_frame.contacts[i];
+    }
+  }
+  return nullptr;
+}
+
+IQS5XX_ContactFilter::Track* IQS5XX_ContactFilter::findTrack(uint8_t id) {
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    if (_tracks[i].id == id) {
+      return &_tracks[i];
+    }
+  }
+  return nullptr;
+}
+
+void IQS5XX_ContactFilter::start(Track &track, const Contact &contact, uint32_t timestampUs) {
+  track.id = contact.id;
+  track.timestampUs = timestampUs;
+  track.x.position = (int32_t)contact.x << 8;
+  track.x.rate = 0;
+  track.y.position = (int32_t)contact.y << 8;
+  track.y.rate = 0;
+}
+
+void IQS5XX_ContactFilter::oneEuro(Axis &axis, uint16_t raw, uint32_t dtUs, uint32_t derivativeAlphaQ16) const {
+  int32_t target = (int32_t)raw << 8;
+
+  // Speed against the previous filtered position, smoothed
+  int32_t derivative = saturate32((int64_t)(target - axis.position) * 1000000 / dtUs);
+  axis.rate += (int32_t)(((int64_t)derivative - axis.rate) * derivativeAlphaQ16 >> 16);
+
+  // Faster movement, higher cutoff, less lag
+  uint32_t speed = (axis.rate < 0) ? -(uint32_t)axis.rate : (uint32_t)axis.rate;
+  uint64_t cutoff = _oneEuro.minCutoffQ8 + (((uint64_t)_oneEuro.betaQ16 * speed) >> 16);
+  int32_t alpha = smoothing(cutoff > MAX_CUTOFF_Q8 ? MAX_CUTOFF_Q8 : (uint32_t)cutoff, dtUs);
+  axis.position += (int32_t)((int64_t)(target - axis.position) * alpha >> 16);
+}
+
+void IQS5XX_ContactFilter::alphaBeta(Axis &axis, uint16_t raw, uint32_t dtUs) const {
+  // Predict with the velocity estimate, then correct by the residual
+  int32_t predicted = axis.position + (int32_t)((int64_t)axis.rate * dtUs / 1000000);
+  int64_t residual = ((int32_t)raw << 8) - predicted;
+  axis.position = predicted + (int32_t)((residual * _alphaBeta.alphaQ16) >> 16);
+  axis.rate = saturate32(axis.rate + ((residual * _alphaBeta.betaQ16) >> 16) * 1000000 / dtUs);
+}
+
+const ContactFrame& IQS5XX_ContactFilter::update(const ContactFrame &contacts, uint32_t timestampUs) {
+  _frame = contacts;
+  if (_type == FILTER_NONE) {
+    return _frame;
+  }
+
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    _tracks[i].seen = false;
+  }
+
+  for (uint8_t i = 0; i < contacts.count; i++) {
+    const Contact &contact = contacts.contacts[i];
+    Contact &filtered = _frame.contacts[i];
+
+    Track* track = (contact.phase == CONTACT_DOWN) ? nullptr : findTrack(contact.id);
+    if (contact.phase == CONTACT_UP) {
+      // Release: last filtered position, then the track is free
+      if (track != nullptr) {
+        filtered.x = toCounts(track->x.position);
+        filtered.y = toCounts(track->y.position);
+        track->id = IQS5XX_CONTACT_ID_NONE;
+      }
+      continue;
+    }
+    if (track == nullptr) {
+      // Touch-down, or a contact seen first mid-stroke
+      track = findTrack(IQS5XX_CONTACT_ID_NONE);
+      if (track != nullptr) {
+        start(*track, contact, timestampUs);
+        track->seen = true;
+      }
+      continue;
+    }
+    track->seen = true;
+
+    uint32_t dt = timestampUs - track->timestampUs;
+    if (dt > IQS5XX_FILTER_MAX_DT_US) {
+      // Too stale to predict from: start over at the reported position
+      start(*track, contact, timestampUs);
+    } else if (dt > 0) {
+      if (_type == FILTER_ONE_EURO) {
+        int32_t derivativeAlpha = smoothing(_oneEuro.derivativeCutoffQ8, dt);
+        oneEuro(track->x, contact.x, dt, derivativeAlpha);
+        oneEuro(track->y, contact.y, dt, derivativeAlpha);
+      } else {
+        alphaBeta(track->x, contact.x, dt);
+        alphaBeta(track->y, contact.y, dt);
+      }
+      track->timestampUs = timestampUs;
+    }
+    filtered.x = toCounts(track->x.position);
+    filtered.y = toCounts(track->y.position);
+  }
+
+  // Contacts that vanished without a lift (e.g. after a tracker reset)
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    if (!_tracks[i].seen) {
+      _tracks[i].id = IQS5XX_CONTACT_ID_NONE;
+    }
+  }
+  return _frame;
+}
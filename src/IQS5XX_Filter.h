@@ -0,0 +1,151 @@
+/**
+ * @file IQS5XX_Filter.h
+ * @brief Fixed-point coordinate smoothing per tracked contact
+ * @author lemio
+ *
+ * Runs after IQS5XX_ContactTracker and hands on a ContactFrame with the
+ * same contacts, so it slots in front of IQS5XX_Kinematics or the
+ * application. Each contact keeps its own state from touch-down to lift.
+ *
+ * - 1-Euro filter: a low-pass whose cutoff rises with the (smoothed)
+ *   speed, so a resting finger is smoothed hard while a moving one lags
+ *   little. Tune the minimum cutoff for jitter at rest, then beta for lag.
+ * - Alpha-beta filter: constant-gain position/velocity tracker. Lag at
+ *   constant speed is close to zero, at the price of some overshoot when
+ *   the finger stops.
+ *
+ * Integer math only with a fixed number of operations per contact (five
+ * 64-bit divisions for the 1-Euro filter, four for alpha-beta), and no
+ * allocation. Positions are filtered with 8 fraction bits; the output
+ * is rounded back to counts.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_FILTER_H
+#define IQS5XX_FILTER_H
+
+#include "IQS5XX_ContactTracker.h"
+
+// Fixed-point parameters from constants, e.g. IQS5XX_Q8(1.5) for 1.5 Hz
+#define IQS5XX_Q8(value)       ((uint32_t)((value) * 256.0 + 0.5))
+#define IQS5XX_Q16(value)      ((uint32_t)((value) * 65536.0 + 0.5))
+
+// Time steps longer than this restart a contact's filter
+#define IQS5XX_FILTER_MAX_DT_US 250000
+
+enum FilterType {
+  FILTER_NONE = 0,    // Positions pass through unchanged
+  FILTER_ONE_EURO,
+  FILTER_ALPHA_BETA
+};
+
+/**
+ * @brief 1-Euro filter parameters
+ */
+struct OneEuroParams {
+  uint32_t minCutoffQ8;         // Cutoff at rest, Hz << 8
+  uint32_t betaQ16;             // Cutoff increase per count/s of speed, Hz << 16
+  uint32_t derivativeCutoffQ8;  // Cutoff of the speed estimate, Hz << 8
+};
+
+/**
+ * @brief Alpha-beta filter parameters
+ */
+struct AlphaBetaParams {
+  uint32_t alphaQ16;            // Position gain, 0 < alpha <= 1, << 16
+  uint32_t betaQ16;             // Velocity gain, 0 <= beta < alpha, << 16
+};
+
+// Defaults tuned with extras/host filter_eval (200 Hz reports, +/-8 counts noise)
+#define IQS5XX_ONE_EURO_DEFAULT   {IQS5XX_Q8(1.0), IQS5XX_Q16(0.02), IQS5XX_Q8(1.0)}
+#define IQS5XX_ALPHA_BETA_DEFAULT {IQS5XX_Q16(0.3), IQS5XX_Q16(0.05)}
+
+/**
+ * @class IQS5XX_ContactFilter
+ * @brief Per-contact 1-Euro or alpha-beta filter on tracked positions
+ */
+class IQS5XX_ContactFilter {
+  public:
+    /**
+     * @brief Constructor; positions pass through until a filter is selected
+     */
+    IQS5XX_ContactFilter();
+
+    /**
+     * @brief Select the 1-Euro filter (forgets all contacts)
+     * @param params Filter parameters
+     */
+    void setOneEuro(const OneEuroParams &params);
+
+    /**
+     * @brief Select the alpha-beta filter (forgets all contacts)
+     * @param params Filter parameters
+     */
+    void setAlphaBeta(const AlphaBetaParams &params);
+
+    /**
+     * @brief Pass positions through unchanged
+     */
+    void disable();
+
+    /**
+     * @brief Selected filter
+     */
+    FilterType type() const { return _type; }
+
+    /**
+     * @brief Filter one tracked frame
+     *
+     * Touch-downs start at the reported position; lifted contacts keep the
+     * last filtered position.
+     * @param contacts Result of IQS5XX_ContactTracker::update()
+     * @param timestampUs Time the frame was read, e.g. micros()
+     * @return The contacts with filtered x/y, valid until the next update()
+     */
+    const ContactFrame& update(const ContactFrame &contacts, uint32_t timestampUs);
+
+    /**
+     * @brief Filtered contacts of the last update()
+     */
+    const ContactFrame& contacts() const { return _frame; }
+
+    /**
+     * @brief Look up a filtered contact of the last update() by ID
+     * @param id Contact ID
+     * @return The contact, or nullptr if it is not in the last frame
+     */
+    const Contact* find(uint8_t id) const;
+
+    /**
+     * @brief Forget all contacts
+     */
+    void reset();
+
+  private:
+    struct Axis {
+      int32_t position;     // counts << 8
+      int32_t rate;         // counts/s << 8: smoothed speed (1-Euro) or velocity (alpha-beta)
+    };
+
+    struct Track {
+      uint8_t id;           // IQS5XX_CONTACT_ID_NONE = free
+      bool seen;            // Referenced by the current frame
+      uint32_t timestampUs;
+      Axis x;
+      Axis y;
+    };
+
+    FilterType _type;
+    OneEuroParams _oneEuro;
+    AlphaBetaParams _alphaBeta;
+    Track _tracks[IQS5XX_MAX_FINGERS];
+    ContactFrame _frame;
+
+    Track* findTrack(uint8_t id);
+    void start(Track &track, const Contact &contact, uint32_t timestampUs);
+    void oneEuro(Axis &axis, uint16_t raw, uint32_t dtUs, uint32_t derivativeAlphaQ16) const;
+    void alphaBeta(Axis &axis, uint16_t raw, uint32_t dtUs) const;
+};
+
+#endif // IQS5XX_FILTER_H
@@ -0,0 +1,96 @@
+/**
+ * @file IQS5XX_FrameQueue.h
+ * @brief Fixed-capacity single-producer/single-consumer frame queue
+ * @author lemio
+ *
+ * Lock-free ring buffer used to hand decoded frames from the acquisition
+ * path (IQS5XX_B000_Trackpad::service()) to the application. One context
+ * may push and one context may pop concurrently without disabling
+ * interrupts; the storage is static so no heap is used.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_FRAME_QUEUE_H
+#define IQS5XX_FRAME_QUEUE_H
+
+#include <stdint.h>
+
+/**
+ * @class IQS5XX_FrameQueue
+ * @brief SPSC ring buffer of frames
+ * @tparam T Frame type (copied in and out by value)
+ * @tparam Capacity Number of slots, must be a power of two no larger than 128
+ */
+template <typename T, uint8_t Capacity>
+class IQS5XX_FrameQueue {
+    static_assert(Capacity > 0 && Capacity <= 128 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two between 1 and 128");
+
+  public:
+    IQS5XX_FrameQueue() : _head(0), _tail(0), _dropped(0) {}
+
+    /**
+     * @brief Append a frame (producer side)
+     * @param frame Frame to copy into the queue
+     * @return true if queued, false if the queue was full and the frame was dropped
+     */
+    bool push(const T &frame) {
+      uint8_t head = _head;
+      if ((uint8_t)(head - _tail) >= Capacity) {
+        _dropped++;
+        return false;
+      }
+      _slots[head & (Capacity - 1)] = frame;
+      // Publish the slot contents before the new head index
+      __sync_synchronize();
+      _head = head + 1;
+      return true;
+    }
+
+    /**
+     * @brief Remove the oldest frame (consumer side)
+     * @param frame Receives the frame
+     * @return true if a frame was available, false if the queue was empty
+     */
+    bool pop(T &frame) {
+      uint8_t tail = _tail;
+      if (tail == _head) {
+        return false;
+      }
+      __sync_synchronize();
+      frame = _slots[tail & (Capacity - 1)];
+      __sync_synchronize();
+      _tail = tail + 1;
+      return true;
+    }
+
+    /**
+     * @brief Number of frames waiting to be popped
+     */
+    uint8_t size() const {
+      return (uint8_t)(_head - _tail);
+    }
+
+    /**
+     * @brief Number of frames discarded because the queue was full
+     */
+    uint32_t dropped() const {
+      return _dropped;
+    }
+
+    /**
+     * @brief Discard all queued frames (only call while neither side is active)
+     */
+    void clear() {
+      _tail = _head;
+    }
+
+  private:
+    T _slots[Capacity];
+    volatile uint8_t _head;   // Written by the producer only
+    volatile uint8_t _tail;   // Written by the consumer only
+    volatile uint32_t _dropped;
+};
+
+#endif // IQS5XX_FRAME_QUEUE_H
@@ -0,0 +1,313 @@
+/**
+ * @file IQS5XX_Gestures.cpp
+ * @brief Host-side gesture recognition on tracked contacts
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Gestures.h"
+
+namespace {
+
+enum State {
+  S_IDLE = 0,     // No fingers
+  S_POSSIBLE,     // Fingers down, nothing decided: tap or hold candidate
+  S_SWIPE,        // Fingers moved together
+  S_PINCH,
+  S_ROTATE,
+  S_WAIT,         // Decided or failed: wait until all fingers lift
+  STATE_COUNT
+};
+
+enum Input {
+  IN_NONE = 0,
+  IN_DOWN,        // A finger landed
+  IN_LIFT,        // A finger lifted, others remain
+  IN_UP,          // No fingers left
+  IN_MOVE,        // Centroid moved beyond the slop
+  IN_SCALE,       // Spread changed beyond the pinch distance
+  IN_TURN,        // Turned beyond the rotation angle
+  IN_HOLD,        // Rested for the hold time
+  INPUT_COUNT
+};
+
+enum Action {
+  A_NONE = 0,
+  A_START,
+  A_REBASE,
+  A_TAP,
+  A_HOLD,
+  A_SWIPE,
+  A_PINCH_BEGIN,
+  A_PINCH_UPDATE,
+  A_PINCH_END,
+  A_ROTATE_BEGIN,
+  A_ROTATE_UPDATE,
+  A_ROTATE_END
+};
+
+struct Transition {
+  uint8_t next;
+  uint8_t action;
+};
+
+#define T(next, action) {S_##next, A_##action}
+const Transition TRANSITIONS[STATE_COUNT][INPUT_COUNT] = {
+  //             NONE                 DOWN                 LIFT                 UP                   MOVE                 SCALE                  TURN                     HOLD
+  /* IDLE */    {T(IDLE, NONE),       T(POSSIBLE, START),  T(IDLE, NONE),       T(IDLE, NONE),       T(IDLE, NONE),       T(IDLE, NONE),         T(IDLE, NONE),           T(IDLE, NONE)},
+  /* POSSIBLE */{T(POSSIBLE, NONE),   T(POSSIBLE, REBASE), T(POSSIBLE, REBASE), T(IDLE, TAP),        T(SWIPE, NONE),      T(PINCH, PINCH_BEGIN), T(ROTATE, ROTATE_BEGIN), T(WAIT, HOLD)},
+  /* SWIPE */   {T(SWIPE, NONE),      T(SWIPE, REBASE),    T(WAIT, SWIPE),      T(IDLE, SWIPE),      T(SWIPE, NONE),      T(PINCH, PINCH_BEGIN), T(ROTATE, ROTATE_BEGIN), T(SWIPE, NONE)},
+  /* PINCH */   {T(PINCH, PINCH_UPDATE), T(WAIT, PINCH_END), T(WAIT, PINCH_END), T(IDLE, PINCH_END), T(PINCH, PINCH_UPDATE), T(PINCH, PINCH_UPDATE), T(PINCH, PINCH_UPDATE), T(PINCH, PINCH_UPDATE)},
+  /* ROTATE */  {T(ROTATE, ROTATE_UPDATE), T(WAIT, ROTATE_END), T(WAIT, ROTATE_END), T(IDLE, ROTATE_END), T(ROTATE, ROTATE_UPDATE), T(ROTATE, ROTATE_UPDATE), T(ROTATE, ROTATE_UPDATE), T(ROTATE, ROTATE_UPDATE)},
+  /* WAIT */    {T(WAIT, NONE),       T(WAIT, NONE),       T(WAIT, NONE),       T(IDLE, NONE),       T(WAIT, NONE),       T(WAIT, NONE),         T(WAIT, NONE),           T(WAIT, NONE)},
+};
+#undef T
+
+int32_t absolute(int32_t value) {
+  return (value < 0) ? -value : value;
+}
+
+int16_t saturate16(int32_t value) {
+  if (value > INT16_MAX) return INT16_MAX;
+  if (value < INT16_MIN) return INT16_MIN;
+  return (int16_t)value;
+}
+
+uint32_t squareRoot(uint64_t value) {
+  uint64_t result = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)result;
+}
+
+// atan(z) for z = 0..1 in Q15, in tenths of a degree (error below 0.3 degrees):
+// atan(z) ~ pi/4 z + 0.273 z (1 - z) radians
+int32_t arctan(int64_t zQ15) {
+  int64_t linear = 450 * zQ15;
+  int64_t curve = ((zQ15 * (32768 - zQ15)) >> 15) * 1564 / 10;
+  return (int32_t)((linear + curve + 16384) >> 15);
+}
+
+// atan2(y, x) in tenths of a degree, -1800..1800
+int16_t arctan2(int64_t y, int64_t x) {
+  if (x == 0 && y == 0) {
+    return 0;
+  }
+  int64_t ax = (x < 0) ? -x : x;
+  int64_t ay = (y < 0) ? -y : y;
+  int32_t angle = (ax >= ay) ? arctan((ay << 15) / ax) : 900 - arctan((ax << 15) / ay);
+  if (x < 0) {
+    angle = 1800 - angle;
+  }
+  return (int16_t)((y < 0) ? -angle : angle);
+}
+
+} // namespace
+
+IQS5XX_GestureEngine::IQS5XX_GestureEngine() : _enabled(IQS5XX_GESTURES_ALL) {
+  const GestureConfig config = IQS5XX_GESTURE_CONFIG_DEFAULT;
+  _config = config;
+  _state = S_IDLE;
+  _startUs = 0;
+  _fingers = 0;
+  _edge = DIRECTION_NONE;
+  _baseX = _baseY = _baseSpread = 0;
+  _baseVectorX = _baseVectorY = 0;
+  _offsetX = _offsetY = 0;
+  _dx = _dy = 0;
+  _scaleQ8 = _reportedScaleQ8 = 256;
+  _angle = _reportedAngle = 0;
+}
+
+void IQS5XX_GestureEngine::reset() {
+  _state = S_WAIT;
+}
+
+void IQS5XX_GestureEngine::measure(const ContactFrame &contacts, int32_t &x, int32_t &y, int32_t &spread) const {
+  uint8_t fingers = contacts.active;
+  int32_t sumX = 0, sumY = 0;
+  for (uint8_t i = 0; i < fingers; i++) {
+    sumX += contacts.contacts[i].x;
+    sumY += contacts.contacts[i].y;
+  }
+  x = sumX / fingers;
+  y = sumY / fingers;
+
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < fingers; i++) {
+    int64_t dx = (int32_t)contacts.contacts[i].x - x;
+    int64_t dy = (int32_t)contacts.contacts[i].y - y;
+    sum += squareRoot((uint64_t)(dx * dx + dy * dy));
+  }
+  spread = sum / fingers;
+}
+
+void IQS5XX_GestureEngine::rebase(const ContactFrame &contacts) {
+  _offsetX += _dx;
+  _offsetY += _dy;
+  _dx = 0;
+  _dy = 0;
+  _scaleQ8 = _reportedScaleQ8 = 256;
+  _angle = _reportedAngle = 0;
+  measure(contacts, _baseX, _baseY, _baseSpread);
+  if (contacts.active >= 2) {
+    _baseVectorX = (int32_t)contacts.contacts[1].x - contacts.contacts[0].x;
+    _baseVectorY = (int32_t)contacts.contacts[1].y - contacts.contacts[0].y;
+  } else {
+    _baseVectorX = 0;
+    _baseVectorY = 0;
+  }
+}
+
+uint8_t IQS5XX_GestureEngine::classify(const ContactFrame &contacts, uint32_t timestampUs) {
+  if (contacts.active == 0) {
+    return IN_UP;
+  }
+  for (uint8_t i = 0; i < contacts.active; i++) {
+    if (contacts.contacts[i].phase == CONTACT_DOWN) {
+      return IN_DOWN;
+    }
+  }
+  if (contacts.count > contacts.active) {
+    return IN_LIFT;
+  }
+  if (_state == S_IDLE || _state == S_WAIT) {
+    return IN_NONE;
+  }
+
+  // Same fingers as the baseline: measure against it
+  int32_t x, y, spread;
+  measure(contacts, x, y, spread);
+  _dx = x - _baseX;
+  _dy = y - _baseY;
+  if (_baseSpread > 0) {
+    uint32_t scale = ((uint32_t)spread << 8) / _baseSpread;
+    _scaleQ8 = (scale > 0xFFFF) ? 0xFFFF : (uint16_t)scale;
+  }
+  if (contacts.active >= 2) {
+    int64_t vx = (int32_t)contacts.contacts[1].x - contacts.contacts[0].x;
+    int64_t vy = (int32_t)contacts.contacts[1].y - contacts.contacts[0].y;
+    _angle = arctan2(_baseVectorX * vy - _baseVectorY * vx, _baseVectorX * vx + _baseVectorY * vy);
+  }
+
+  bool several = contacts.active >= 2;
+  if (several && enabled(GESTURE_PINCH) && absolute(spread - _baseSpread) > _config.pinchDistance) {
+    return IN_SCALE;
+  }
+  if (several && enabled(GESTURE_ROTATE) && absolute(_angle) > _config.rotateAngle) {
+    return IN_TURN;
+  }
+  if (absolute(_dx) > _config.slop || absolute(_dy) > _config.slop) {
+    return IN_MOVE;
+  }
+  if (enabled(GESTURE_HOLD) && timestampUs - _startUs >= _config.holdUs) {
+    return IN_HOLD;
+  }
+  return IN_NONE;
+}
+
+bool IQS5XX_GestureEngine::perform(uint8_t action, uint32_t timestampUs, GestureEvent &event) {
+  event.type = GESTURE_NONE;
+  event.phase = GESTURE_END;
+  event.direction = DIRECTION_NONE;
+  event.fingers = _fingers;
+  event.dx = saturate16(_offsetX + _dx);
+  event.dy = saturate16(_offsetY + _dy);
+  event.scaleQ8 = _scaleQ8;
+  event.angle = _angle;
+  event.durationUs = timestampUs - _startUs;
+
+  switch (action) {
+    case A_TAP:
+      if (enabled(GESTURE_TAP) && event.durationUs <= _config.tapMaxUs) {
+        event.type = GESTURE_TAP;
+      }
+      break;
+    case A_HOLD:
+      event.type = GESTURE_HOLD;
+      break;
+    case A_SWIPE: {
+      int32_t dx = _offsetX + _dx;
+      int32_t dy = _offsetY + _dy;
+      if (absolute(dx) >= absolute(dy)) {
+        event.direction = (dx >= 0) ? DIRECTION_X_PLUS : DIRECTION_X_MINUS;
+      } else {
+        event.direction = (dy >= 0) ? DIRECTION_Y_PLUS : DIRECTION_Y_MINUS;
+      }
+      int32_t distance = (absolute(dx) > absolute(dy)) ? absolute(dx) : absolute(dy);
+      GestureType type = (event.direction == _edge && enabled(GESTURE_EDGE_SWIPE)) ? GESTURE_EDGE_SWIPE
+                                                                                    : GESTURE_SWIPE;
+      if (enabled(type) && distance >= _config.swipeDistance && event.durationUs <= _config.swipeMaxUs) {
+        event.type = type;
+      }
+      break;
+    }
+    case A_PINCH_BEGIN:
+    case A_PINCH_UPDATE:
+    case A_PINCH_END:
+      if (action != A_PINCH_UPDATE || _scaleQ8 != _reportedScaleQ8) {
+        event.type = GESTURE_PINCH;
+        event.phase = (action == A_PINCH_BEGIN) ? GESTURE_BEGIN : (action == A_PINCH_END) ? GESTURE_END
+                                                                                          : GESTURE_UPDATE;
+        _reportedScaleQ8 = _scaleQ8;
+      }
+      break;
+    case A_ROTATE_BEGIN:
+    case A_ROTATE_UPDATE:
+    case A_ROTATE_END:
+      if (action != A_ROTATE_UPDATE || _angle != _reportedAngle) {
+        event.type = GESTURE_ROTATE;
+        event.phase = (action == A_ROTATE_BEGIN) ? GESTURE_BEGIN : (action == A_ROTATE_END) ? GESTURE_END
+                                                                                            : GESTURE_UPDATE;
+        _reportedAngle = _angle;
+      }
+      break;
+    default:
+      break;
+  }
+  return event.type != GESTURE_NONE;
+}
+
+bool IQS5XX_GestureEngine::update(const ContactFrame &contacts, uint32_t timestampUs, GestureEvent &event) {
+  uint8_t input = classify(contacts, timestampUs);
+  const Transition &transition = TRANSITIONS[_state][input];
+  _state = transition.next;
+
+  if (transition.action == A_START) {
+    // New session: the first finger decides the edge zone
+    _startUs = timestampUs;
+    _fingers = 0;
+    _offsetX = _offsetY = 0;
+    _dx = _dy = 0;
+    _edge = DIRECTION_NONE;
+    const Contact &first = contacts.contacts[0];
+    if (_config.width > 0 && first.x < _config.edgeMargin) {
+      _edge = DIRECTION_X_PLUS;
+    } else if (_config.width > 0 && first.x >= _config.width - _config.edgeMargin) {
+      _edge = DIRECTION_X_MINUS;
+    } else if (_config.height > 0 && first.y < _config.edgeMargin) {
+      _edge = DIRECTION_Y_PLUS;
+    } else if (_config.height > 0 && first.y >= _config.height - _config.edgeMargin) {
+      _edge = DIRECTION_Y_MINUS;
+    }
+  }
+  if (transition.action == A_START || transition.action == A_REBASE) {
+    rebase(contacts);
+  }
+  if (contacts.active > _fingers) {
+    _fingers = contacts.active;
+  }
+  return perform(transition.action, timestampUs, event);
+}
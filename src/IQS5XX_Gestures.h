@@ -0,0 +1,168 @@
+/**
+ * @file IQS5XX_Gestures.h
+ * @brief Host-side gesture recognition on tracked contacts
+ * @author lemio
+ *
+ * An alternative to the device's fixed-function gesture flags: taps and
+ * press-and-hold with any number of fingers, swipes with any number of
+ * fingers, edge swipes, pinch with a scale ratio and rotation with an
+ * angle. With recognition on the host the on-chip engine can be turned off
+ * (IQS5XX_B000_Trackpad::setDeviceGestures(0, 0)).
+ *
+ * One touch session runs from the first finger down until all fingers
+ * have lifted. Each frame is reduced to one input (a finger landed or
+ * lifted, the fingers moved, spread, turned, or rested long enough) and a
+ * fixed state x input transition table selects the next state and the
+ * action that emits an event. Centroid, spread and angle are measured
+ * against a baseline that is re-taken whenever the set of fingers changes.
+ *
+ * Integer math only (one square root per finger, one arctangent per frame)
+ * and no allocation, so the same frames always give the same events; see
+ * extras/host gesture_replay for replaying recorded traces.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_GESTURES_H
+#define IQS5XX_GESTURES_H
+
+#include "IQS5XX_ContactTracker.h"
+
+enum GestureType {
+  GESTURE_NONE = 0,
+  GESTURE_TAP,          // All fingers lifted quickly without moving
+  GESTURE_HOLD,         // Fingers rested without moving
+  GESTURE_SWIPE,        // Fast movement of all fingers in one direction
+  GESTURE_EDGE_SWIPE,   // Swipe that started at a pad edge, away from it
+  GESTURE_PINCH,        // Fingers spreading or closing (BEGIN/UPDATE/END)
+  GESTURE_ROTATE        // Fingers turning around their centroid (BEGIN/UPDATE/END)
+};
+
+enum GesturePhase {
+  GESTURE_BEGIN = 0,
+  GESTURE_UPDATE,
+  GESTURE_END           // Also used for single-shot gestures
+};
+
+// Direction of movement, named like the device's swipe flags
+enum GestureDirection {
+  DIRECTION_NONE = 0,
+  DIRECTION_X_PLUS,
+  DIRECTION_X_MINUS,
+  DIRECTION_Y_PLUS,
+  DIRECTION_Y_MINUS
+};
+
+// Bit of a gesture type in the mask passed to setEnabled()
+#define IQS5XX_GESTURE_BIT(type)      (1 << (type))
+#define IQS5XX_GESTURES_ALL           0x7E
+
+/**
+ * @brief One recognized gesture
+ */
+struct GestureEvent {
+  GestureType type;
+  GesturePhase phase;
+  GestureDirection direction;   // Swipes and edge swipes
+  uint8_t fingers;              // Most fingers down during the session
+  int16_t dx;                   // Centroid displacement since touch-down, counts
+  int16_t dy;
+  uint16_t scaleQ8;             // Pinch: spread relative to its start, 256 = unchanged
+  int16_t angle;                // Rotate: tenths of a degree from +x towards +y
+  uint32_t durationUs;          // Since the first finger landed
+};
+
+/**
+ * @brief Recognition thresholds
+ */
+struct GestureConfig {
+  uint32_t tapMaxUs;            // Longest tap
+  uint32_t holdUs;              // Rest before a hold
+  uint32_t swipeMaxUs;          // Longest swipe, slower movement is no swipe
+  uint16_t slop;                // Movement per axis that still counts as resting
+  uint16_t swipeDistance;       // Shortest swipe
+  uint16_t pinchDistance;       // Spread change that starts a pinch
+  uint16_t rotateAngle;         // Turn that starts a rotation, tenths of a degree
+  uint16_t edgeMargin;          // Width of the edge zones
+  uint16_t width;               // Pad X/Y resolution (0x066E/0x0670); 0 = no edge swipes
+  uint16_t height;
+};
+
+#define IQS5XX_GESTURE_CONFIG_DEFAULT {200000, 500000, 800000, 40, 200, 60, 150, 64, 0, 0}
+
+/**
+ * @class IQS5XX_GestureEngine
+ * @brief Table-driven gesture recognizer fed with ContactFrames
+ */
+class IQS5XX_GestureEngine {
+  public:
+    IQS5XX_GestureEngine();
+
+    /**
+     * @brief Add one tracked frame
+     *
+     * Call with every frame, including frames without fingers, so the end
+     * of a session is seen. A frame produces at most one event.
+     * @param contacts Result of IQS5XX_ContactTracker::update() (or of
+     *                 IQS5XX_ContactFilter::update())
+     * @param timestampUs Time the frame was read, e.g. micros()
+     * @param event Filled in if a gesture was recognized
+     * @return true if event holds a new gesture
+     */
+    bool update(const ContactFrame &contacts, uint32_t timestampUs, GestureEvent &event);
+
+    /**
+     * @brief Set the recognition thresholds
+     * @param config Thresholds; set width/height to enable edge swipes
+     */
+    void setConfig(const GestureConfig &config) { _config = config; }
+
+    /**
+     * @brief Current recognition thresholds
+     */
+    const GestureConfig& config() const { return _config; }
+
+    /**
+     * @brief Choose the gestures reported
+     *
+     * Disabled gestures are not considered at all, e.g. with pinch off two
+     * spreading fingers can still swipe.
+     * @param mask OR of IQS5XX_GESTURE_BIT(type), default IQS5XX_GESTURES_ALL
+     */
+    void setEnabled(uint8_t mask) { _enabled = mask; }
+
+    /**
+     * @brief Abandon the current session; the engine waits until all fingers lift
+     */
+    void reset();
+
+  private:
+    GestureConfig _config;
+    uint8_t _enabled;
+    uint8_t _state;
+
+    uint32_t _startUs;
+    uint8_t _fingers;             // Most fingers down in this session
+    GestureDirection _edge;       // Swipe direction that leaves the start edge
+
+    // Baseline, re-taken when fingers land or lift
+    int32_t _baseX, _baseY;       // Centroid
+    int32_t _baseSpread;          // Mean distance from the centroid
+    int32_t _baseVectorX, _baseVectorY;   // First to second finger
+    int32_t _offsetX, _offsetY;   // Displacement before the last baseline
+
+    // Measured against the baseline in the last frame without a change
+    int32_t _dx, _dy;
+    uint16_t _scaleQ8;
+    int16_t _angle;
+    uint16_t _reportedScaleQ8;
+    int16_t _reportedAngle;
+
+    uint8_t classify(const ContactFrame &contacts, uint32_t timestampUs);
+    void measure(const ContactFrame &contacts, int32_t &x, int32_t &y, int32_t &spread) const;
+    void rebase(const ContactFrame &contacts);
+    bool perform(uint8_t action, uint32_t timestampUs, GestureEvent &event);
+    bool enabled(GestureType type) const { return (_enabled & IQS5XX_GESTURE_BIT(type)) != 0; }
+};
+
+#endif // IQS5XX_GESTURES_H
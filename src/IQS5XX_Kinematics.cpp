@@ -0,0 +1,200 @@
+/**
+ * @file IQS5XX_Kinematics.cpp
+ * @brief Fixed-point velocity and acceleration per tracked contact
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Kinematics.h"
+
+#include <string.h>
+
+namespace {
+
+int32_t saturate32(int64_t value) {
+  if (value > INT32_MAX) return INT32_MAX;
+  if (value < INT32_MIN) return INT32_MIN;
+  return (int32_t)value;
+}
+
+int16_t saturate16(int32_t value) {
+  if (value > INT16_MAX) return INT16_MAX;
+  if (value < INT16_MIN) return INT16_MIN;
+  return (int16_t)value;
+}
+
+// Displacement over time as counts/s << IQS5XX_VELOCITY_SHIFT
+int32_t velocity(int32_t displacement, uint32_t dtUs) {
+  return saturate32(((int64_t)displacement * (1000000LL << IQS5XX_VELOCITY_SHIFT)) / (int64_t)dtUs);
+}
+
+// Velocity change between two segments whose centres are spanUs apart
+int32_t acceleration(int32_t newer, int32_t older, uint32_t spanUs) {
+  return saturate32((((int64_t)newer - older) * 1000000LL / (int64_t)spanUs) >> IQS5XX_VELOCITY_SHIFT);
+}
+
+void clear(ContactMotion &motion) {
+  motion.samples = 0;
+  motion.vx = 0;
+  motion.vy = 0;
+  motion.ax = 0;
+  motion.ay = 0;
+}
+
+} // namespace
+
+IQS5XX_Kinematics::IQS5XX_Kinematics() : _windowUs(IQS5XX_KINEMATICS_WINDOW_US), _useRelative(true) {
+  reset();
+}
+
+void IQS5XX_Kinematics::reset() {
+  memset(_tracks, 0, sizeof(_tracks));
+  memset(&_frame, 0, sizeof(_frame));
+}
+
+const ContactMotion* IQS5XX_Kinematics::find(uint8_t id) const {
+  for (uint8_t i = 0; i < _frame.count; i++) {
+    if (_frame.motion[i].id == id) {
+      return &_frame.motion[i];
+    }
+  }
+  return nullptr;
+}
+
+IQS5XX_Kinematics::Track* IQS5XX_Kinematics::findTrack(uint8_t id) {
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    if (_tracks[i].id == id) {
+      return &_tracks[i];
+    }
+  }
+  return nullptr;
+}
+
+IQS5XX_Kinematics::Track* IQS5XX_Kinematics::startTrack(const Contact &contact, uint32_t timestampUs) {
+  Track* track = findTrack(IQS5XX_CONTACT_ID_NONE);
+  if (track == nullptr) {
+    return nullptr;
+  }
+  track->id = contact.id;
+  track->slot = contact.slot;
+  track->x = contact.x;
+  track->y = contact.y;
+  track->timestampUs = timestampUs;
+  track->head = 0;
+  track->count = 0;
+  return track;
+}
+
+void IQS5XX_Kinematics::estimate(const Track &track, ContactMotion &motion) const {
+  clear(motion);
+
+  // Newest samples first, until they span the window
+  int32_t sumX = 0, sumY = 0;
+  uint32_t sumDt = 0;
+  uint8_t used = 0;
+  uint8_t index = track.head;
+  while (used < track.count && (used == 0 || sumDt < _windowUs)) {
+    index = (index == 0) ? IQS5XX_KINEMATICS_HISTORY - 1 : index - 1;
+    sumX += track.dx[index];
+    sumY += track.dy[index];
+    sumDt += track.dt[index];
+    used++;
+  }
+  if (used == 0) {
+    return;
+  }
+  motion.samples = used;
+  motion.vx = velocity(sumX, sumDt);
+  motion.vy = velocity(sumY, sumDt);
+  if (used < 2) {
+    return;
+  }
+
+  // Newer half against older half
+  int32_t newerX = 0, newerY = 0;
+  uint32_t newerDt = 0;
+  index = track.head;
+  for (uint8_t n = 0; n < used / 2; n++) {
+    index = (index == 0) ? IQS5XX_KINEMATICS_HISTORY - 1 : index - 1;
+    newerX += track.dx[index];
+    newerY += track.dy[index];
+    newerDt += track.dt[index];
+  }
+  uint32_t olderDt = sumDt - newerDt;
+  uint32_t span = sumDt / 2;
+  motion.ax = acceleration(velocity(newerX, newerDt), velocity(sumX - newerX, olderDt), span);
+  motion.ay = acceleration(velocity(newerY, newerDt), velocity(sumY - newerY, olderDt), span);
+}
+
+const MotionFrame& IQS5XX_Kinematics::update(const ContactFrame &contacts, const MultiTouchFrame &frame,
+                                             uint32_t timestampUs) {
+  // Free the tracks of lifted and vanished contacts before any touch-down
+  // takes one: a finger landing in the frame another lifts needs the slot
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    _tracks[i].seen = false;
+  }
+  _frame.count = contacts.count;
+  for (uint8_t i = 0; i < contacts.count; i++) {
+    const Contact &contact = contacts.contacts[i];
+    if (contact.phase == CONTACT_DOWN) {
+      continue;
+    }
+    Track* track = findTrack(contact.id);
+    if (contact.phase == CONTACT_UP) {
+      // Release: last estimate, then the track is free
+      ContactMotion &motion = _frame.motion[i];
+      motion.id = contact.id;
+      if (track != nullptr) {
+        estimate(*track, motion);
+        track->id = IQS5XX_CONTACT_ID_NONE;
+      } else {
+        clear(motion);
+      }
+    } else if (track != nullptr) {
+      track->seen = true;
+    }
+  }
+  // Contacts that vanished without a lift (e.g. after a tracker reset)
+  for (uint8_t i = 0; i < IQS5XX_MAX_FINGERS; i++) {
+    if (!_tracks[i].seen) {
+      _tracks[i].id = IQS5XX_CONTACT_ID_NONE;
+    }
+  }
+
+  for (uint8_t i = 0; i < contacts.count; i++) {
+    const Contact &contact = contacts.contacts[i];
+    if (contact.phase == CONTACT_UP) {
+      continue;
+    }
+    ContactMotion &motion = _frame.motion[i];
+    motion.id = contact.id;
+
+    Track* track = (contact.phase == CONTACT_DOWN) ? nullptr : findTrack(contact.id);
+    if (track == nullptr) {
+      // Touch-down, or a contact seen first mid-stroke
+      startTrack(contact, timestampUs);
+      clear(motion);
+      continue;
+    }
+
+    uint32_t dt = timestampUs - track->timestampUs;
+    if (dt > 0) {
+      // The device reports relative movement for the finger in slot 0 only
+      bool relative = _useRelative && contact.slot == 0 && track->slot == 0;
+      track->dx[track->head] = relative ? frame.relX : saturate16((int32_t)contact.x - track->x);
+      track->dy[track->head] = relative ? frame.relY : saturate16((int32_t)contact.y - track->y);
+      track->dt[track->head] = dt;
+      track->head = (track->head + 1) % IQS5XX_KINEMATICS_HISTORY;
+      if (track->count < IQS5XX_KINEMATICS_HISTORY) {
+        track->count++;
+      }
+      track->x = contact.x;
+      track->y = contact.y;
+      track->slot = contact.slot;
+      track->timestampUs = timestampUs;
+    }
+    estimate(*track, motion);
+  }
+  return _frame;
+}
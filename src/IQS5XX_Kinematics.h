@@ -0,0 +1,136 @@
+/**
+ * @file IQS5XX_Kinematics.h
+ * @brief Fixed-point velocity and acceleration per tracked contact
+ * @author lemio
+ *
+ * Runs after IQS5XX_ContactTracker. Every contact keeps a short ring of
+ * per-frame displacements and time steps. For the finger in slot 0 the
+ * displacement is the device's own relative movement (REL_X/REL_Y), for
+ * the others the difference of absolute positions. REL_X/REL_Y cover one
+ * report, so turn them off with useRelativeData(false) if reports can be
+ * skipped (e.g. in event mode).
+ *
+ * Velocity is the displacement summed over the newest samples within the
+ * window divided by their time. Acceleration compares the velocity of the
+ * newer half of those samples with the older half.
+ *
+ * Integer math only (one 64-bit division per axis and estimate), so it
+ * suits MCUs without an FPU. Velocities are counts per second in Q24.8,
+ * accelerations counts per second squared.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_KINEMATICS_H
+#define IQS5XX_KINEMATICS_H
+
+#include "IQS5XX_ContactTracker.h"
+
+// Displacements kept per contact
+#ifndef IQS5XX_KINEMATICS_HISTORY
+#define IQS5XX_KINEMATICS_HISTORY     8
+#endif
+
+// Default estimation window
+#define IQS5XX_KINEMATICS_WINDOW_US   50000
+
+// Fraction bits of ContactMotion velocities
+#define IQS5XX_VELOCITY_SHIFT         8
+
+/**
+ * @brief Motion estimate of one contact
+ */
+struct ContactMotion {
+  uint8_t id;         // Contact ID, as in the ContactFrame
+  uint8_t samples;    // Displacements used, 0 = no estimate yet (first frame)
+  int32_t vx;         // Velocity in counts/s << IQS5XX_VELOCITY_SHIFT
+  int32_t vy;
+  int32_t ax;         // Acceleration in counts/s^2, 0 with fewer than 2 samples
+  int32_t ay;
+};
+
+/**
+ * @brief Motion estimates of one frame
+ *
+ * motion[i] belongs to contacts[i] of the ContactFrame passed to update();
+ * lifted contacts carry their release velocity.
+ */
+struct MotionFrame {
+  uint8_t count;
+  ContactMotion motion[IQS5XX_MAX_CONTACTS];
+};
+
+/**
+ * @class IQS5XX_Kinematics
+ * @brief Per-contact velocity/acceleration estimator with bounded history
+ */
+class IQS5XX_Kinematics {
+  public:
+    IQS5XX_Kinematics();
+
+    /**
+     * @brief Add one tracked frame
+     * @param contacts Result of IQS5XX_ContactTracker::update() for frame
+     * @param frame The frame itself, for the relative movement of slot 0
+     * @param timestampUs Time the frame was read, e.g. micros()
+     * @return Estimates in the order of contacts, valid until the next update()
+     */
+    const MotionFrame& update(const ContactFrame &contacts, const MultiTouchFrame &frame,
+                              uint32_t timestampUs);
+
+    /**
+     * @brief Estimates of the last update()
+     */
+    const MotionFrame& motion() const { return _frame; }
+
+    /**
+     * @brief Look up the estimate of a contact from the last update()
+     * @param id Contact ID
+     * @return The estimate, or nullptr if the contact is not in the last frame
+     */
+    const ContactMotion* find(uint8_t id) const;
+
+    /**
+     * @brief Set how far back estimates look
+     * @param windowUs Newest samples spanning at least this time are used
+     *                 (bounded by IQS5XX_KINEMATICS_HISTORY)
+     */
+    void setWindow(uint32_t windowUs) { _windowUs = windowUs; }
+
+    /**
+     * @brief Use the device's relative movement for slot 0 (default on)
+     * @param enable false to difference absolute positions for every contact
+     */
+    void useRelativeData(bool enable) { _useRelative = enable; }
+
+    /**
+     * @brief Forget all contacts
+     */
+    void reset();
+
+  private:
+    struct Track {
+      uint8_t id;           // IQS5XX_CONTACT_ID_NONE = free
+      uint8_t slot;
+      bool seen;            // Referenced by the current frame
+      uint16_t x;
+      uint16_t y;
+      uint32_t timestampUs;
+      uint8_t head;         // Next ring entry to write
+      uint8_t count;
+      int16_t dx[IQS5XX_KINEMATICS_HISTORY];
+      int16_t dy[IQS5XX_KINEMATICS_HISTORY];
+      uint32_t dt[IQS5XX_KINEMATICS_HISTORY];
+    };
+
+    Track _tracks[IQS5XX_MAX_FINGERS];
+    MotionFrame _frame;
+    uint32_t _windowUs;
+    bool _useRelative;
+
+    Track* findTrack(uint8_t id);
+    Track* startTrack(const Contact &contact, uint32_t timestampUs);
+    void estimate(const Track &track, ContactMotion &motion) const;
+};
+
+#endif // IQS5XX_KINEMATICS_H
@@ -0,0 +1,224 @@
+/**
+ * @file IQS5XX_Scroll.cpp
+ * @brief Two-finger scrolling with inertia (momentum after release)
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Scroll.h"
+
+#include <string.h>
+
+namespace {
+
+int32_t absolute(int32_t value) {
+  return (value < 0) ? -value : value;
+}
+
+int16_t saturate16(int32_t value) {
+  if (value > INT16_MAX) return INT16_MAX;
+  if (value < INT16_MIN) return INT16_MIN;
+  return (int16_t)value;
+}
+
+// exp(-period / timeConstant) << 16, as (1 - x / 256)^256 in Q30
+uint32_t decayPerTick(uint32_t periodUs, uint32_t timeConstantUs) {
+  if (timeConstantUs == 0) {
+    return 0;
+  }
+  uint64_t x = ((uint64_t)periodUs << 30) / timeConstantUs;
+  if (x >= (256ULL << 30)) {
+    return 0;
+  }
+  uint64_t y = (1ULL << 30) - (x >> 8);
+  for (uint8_t i = 0; i < 8; i++) {
+    y = (y * y) >> 30;
+  }
+  return (uint32_t)(y >> 14);
+}
+
+} // namespace
+
+IQS5XX_InertialScroll::IQS5XX_InertialScroll() : _callback(nullptr), _context(nullptr) {
+  const ScrollConfig config = IQS5XX_SCROLL_CONFIG_DEFAULT;
+  setConfig(config);
+  memset(&_event, 0, sizeof(_event));
+  stop();
+}
+
+void IQS5XX_InertialScroll::setConfig(const ScrollConfig &config) {
+  _config = config;
+  if (_config.outputPeriodUs == 0) {
+    _config.outputPeriodUs = 1;
+  }
+  _decayQ16 = decayPerTick(_config.outputPeriodUs, _config.timeConstantUs);
+}
+
+void IQS5XX_InertialScroll::setCallback(IQS5XX_ScrollCallback callback, void* context) {
+  _callback = callback;
+  _context = context;
+}
+
+void IQS5XX_InertialScroll::stop() {
+  _dragging = false;
+  _coasting = false;
+  _ticking = false;
+  _ids[0] = _ids[1] = IQS5XX_CONTACT_ID_NONE;
+  _centroidX = _centroidY = 0;
+  _pendingX = _pendingY = 0;
+  _velocityX = _velocityY = 0;
+  _countX = _countY = 0;
+  _detentX = _detentY = 0;
+}
+
+void IQS5XX_InertialScroll::update(const ContactFrame &contacts, const MotionFrame &motion, uint32_t timestampUs) {
+  // A finger landing catches the coasting stream
+  for (uint8_t i = 0; i < contacts.active && _coasting; i++) {
+    if (contacts.contacts[i].phase == CONTACT_DOWN) {
+      _coasting = false;
+      _velocityX = _velocityY = 0;
+    }
+  }
+
+  if (contacts.active == 2) {
+    const Contact &a = contacts.contacts[0];
+    const Contact &b = contacts.contacts[1];
+    int32_t x = ((int32_t)a.x + b.x) << 7;
+    int32_t y = ((int32_t)a.y + b.y) << 7;
+    bool same = _dragging && ((a.id == _ids[0] && b.id == _ids[1]) || (a.id == _ids[1] && b.id == _ids[0]));
+    if (same) {
+      _pendingX += x - _centroidX;
+      _pendingY += y - _centroidY;
+    } else {
+      // New pair of fingers: start a fresh stream
+      _dragging = true;
+      _coasting = false;
+      _ids[0] = a.id;
+      _ids[1] = b.id;
+      _pendingX = _pendingY = 0;
+      _countX = _countY = 0;
+      _detentX = _detentY = 0;
+    }
+    _centroidX = x;
+    _centroidY = y;
+    if (!_ticking) {
+      _ticking = true;
+      _nextTickUs = timestampUs + _config.outputPeriodUs;
+    }
+    return;
+  }
+
+  if (_dragging) {
+    _dragging = false;
+    // Fingers lifting start coasting; a third finger just ends the scroll
+    if (contacts.active < 2) {
+      release(contacts, motion);
+    }
+  }
+}
+
+void IQS5XX_InertialScroll::release(const ContactFrame &contacts, const MotionFrame &motion) {
+  // Average velocity of the pair: release estimates of lifted contacts,
+  // current ones of a finger still down
+  int32_t sumX = 0, sumY = 0;
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < contacts.count && i < motion.count; i++) {
+    const ContactMotion &m = motion.motion[i];
+    if ((m.id == _ids[0] || m.id == _ids[1]) && m.samples > 0) {
+      sumX += m.vx / 2;
+      sumY += m.vy / 2;
+      count++;
+    }
+  }
+  if (count == 0) {
+    return;
+  }
+  int32_t vx = (count == 2) ? sumX : sumX * 2;
+  int32_t vy = (count == 2) ? sumY : sumY * 2;
+  uint32_t minimum = _config.minVelocity << IQS5XX_VELOCITY_SHIFT;
+  if ((uint32_t)absolute(vx) < minimum && (uint32_t)absolute(vy) < minimum) {
+    return;
+  }
+  _coasting = true;
+  _velocityX = vx;
+  _velocityY = vy;
+}
+
+int8_t IQS5XX_InertialScroll::detents(int32_t &remainder, int16_t countsPerDetent) {
+  if (countsPerDetent == 0) {
+    remainder = 0;
+    return 0;
+  }
+  int32_t unit = (int32_t)countsPerDetent << 8;
+  int32_t steps = remainder / unit;
+  if (steps > 127) steps = 127;
+  if (steps < -127) steps = -127;
+  remainder -= steps * unit;
+  return (int8_t)steps;
+}
+
+bool IQS5XX_InertialScroll::service(uint32_t nowUs) {
+  if (!_ticking || (int32_t)(nowUs - _nextTickUs) < 0) {
+    return false;
+  }
+  uint32_t period = _config.outputPeriodUs;
+  uint32_t ticks = (nowUs - _nextTickUs) / period + 1;
+  uint32_t tickUs = _nextTickUs + (ticks - 1) * period;
+  if (ticks > IQS5XX_SCROLL_MAX_CATCH_UP) {
+    ticks = IQS5XX_SCROLL_MAX_CATCH_UP;
+    tickUs = nowUs;
+    _nextTickUs = nowUs + period;
+  } else {
+    _nextTickUs += ticks * period;
+  }
+
+  // Drag movement since the last tick, then the coasting steps
+  int32_t moveX = _pendingX;
+  int32_t moveY = _pendingY;
+  _pendingX = _pendingY = 0;
+  bool momentum = _coasting;
+  uint32_t minimum = _config.minVelocity << IQS5XX_VELOCITY_SHIFT;
+  for (uint32_t n = 0; n < ticks && _coasting; n++) {
+    moveX += (int32_t)((int64_t)_velocityX * period / 1000000);
+    moveY += (int32_t)((int64_t)_velocityY * period / 1000000);
+    _velocityX = (int32_t)(((int64_t)_velocityX * _decayQ16) >> 16);
+    _velocityY = (int32_t)(((int64_t)_velocityY * _decayQ16) >> 16);
+    if ((uint32_t)absolute(_velocityX) < minimum && (uint32_t)absolute(_velocityY) < minimum) {
+      _coasting = false;
+      _velocityX = _velocityY = 0;
+    }
+  }
+
+  _countX += moveX;
+  _countY += moveY;
+  _detentX += moveX;
+  _detentY += moveY;
+  int16_t dx = saturate16(_countX / 256);
+  int16_t dy = saturate16(_countY / 256);
+  _countX -= (int32_t)dx * 256;
+  _countY -= (int32_t)dy * 256;
+  int8_t pan = detents(_detentX, _config.countsPerDetentX);
+  int8_t wheel = detents(_detentY, _config.countsPerDetentY);
+
+  if (!_dragging && !_coasting) {
+    // Stream ended: leftover fractions are dropped
+    _ticking = false;
+    _countX = _countY = 0;
+    _detentX = _detentY = 0;
+  }
+  if (dx == 0 && dy == 0 && pan == 0 && wheel == 0) {
+    return false;
+  }
+
+  _event.timestampUs = tickUs;
+  _event.dx = dx;
+  _event.dy = dy;
+  _event.pan = pan;
+  _event.wheel = wheel;
+  _event.momentum = momentum;
+  if (_callback != nullptr) {
+    _callback(_event, _context);
+  }
+  return true;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file IQS5XX_Scroll.h
+ * @brief Two-finger scrolling with inertia (momentum after release)
+ * @author lemio
+ *
+ * The device's scroll gesture is a single flag without magnitude. This
+ * stage turns two-finger movement into a scroll stream instead: while two
+ * fingers drag, the stream follows their centroid; when they lift, it
+ * continues with their release velocity (from IQS5XX_Kinematics) and
+ * decays exponentially until it falls below a minimum speed. A new touch
+ * stops it.
+ *
+ * Frames go in through update() at the sensor's report rate; service()
+ * emits the stream at its own output rate (e.g. the HID polling rate), so
+ * coasting continues between and after reports. Each output tick carries
+ * pad counts for UIs and whole HID wheel/pan detents; sub-count and
+ * sub-detent remainders carry over to the next tick, so nothing is lost
+ * to rounding.
+ *
+ * Fixed point throughout: velocities in counts/s << IQS5XX_VELOCITY_SHIFT,
+ * the per-tick decay factor << 16 (computed once per setConfig()).
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_SCROLL_H
+#define IQS5XX_SCROLL_H
+
+#include "IQS5XX_Kinematics.h"
+
+// Late service() calls catch up at most this many ticks, then resynchronize
+#define IQS5XX_SCROLL_MAX_CATCH_UP 8
+
+/**
+ * @brief Scroll stream settings
+ */
+struct ScrollConfig {
+  uint32_t outputPeriodUs;      // Time between output ticks
+  uint32_t timeConstantUs;      // Coasting velocity falls to 1/e in this time
+  uint32_t minVelocity;         // counts/s: slower releases do not coast, coasting stops below
+  int16_t countsPerDetentX;     // Pad counts per HID pan step; the sign sets the direction, 0 = off
+  int16_t countsPerDetentY;     // Pad counts per HID wheel step; the sign sets the direction, 0 = off
+};
+
+// 100 Hz output, 400 ms decay, "natural" direction (content follows the fingers)
+#define IQS5XX_SCROLL_CONFIG_DEFAULT {10000, 400000, 100, -64, 64}
+
+/**
+ * @brief Scroll output of one tick
+ */
+struct ScrollEvent {
+  uint32_t timestampUs;         // Tick time
+  int16_t dx;                   // Pad counts since the previous event
+  int16_t dy;
+  int8_t pan;                   // HID AC Pan detents (positive = right)
+  int8_t wheel;                 // HID wheel detents (positive = up)
+  bool momentum;                // true while coasting after release
+};
+
+/**
+ * @brief Scroll event callback
+ * @param event Output of one tick
+ * @param context Pointer passed to setCallback()
+ */
+typedef void (*IQS5XX_ScrollCallback)(const ScrollEvent &event, void* context);
+
+/**
+ * @class IQS5XX_InertialScroll
+ * @brief Two-finger drag plus decaying momentum, at a fixed output rate
+ */
+class IQS5XX_InertialScroll {
+  public:
+    IQS5XX_InertialScroll();
+
+    /**
+     * @brief Set the output rate, decay and detent sizes
+     */
+    void setConfig(const ScrollConfig &config);
+
+    /**
+     * @brief Current settings
+     */
+    const ScrollConfig& config() const { return _config; }
+
+    /**
+     * @brief Call a function for every event service() emits
+     * @param callback Function, or nullptr to only poll event()
+     * @param context Passed to the callback
+     */
+    void setCallback(IQS5XX_ScrollCallback callback, void* context = nullptr);
+
+    /**
+     * @brief Add one tracked frame
+     * @param contacts Result of IQS5XX_ContactTracker::update()
+     * @param motion Result of IQS5XX_Kinematics::update() for the same frame
+     * @param timestampUs Time the frame was read, e.g. micros()
+     */
+    void update(const ContactFrame &contacts, const MotionFrame &motion, uint32_t timestampUs);
+
+    /**
+     * @brief Run the output ticks that are due
+     *
+     * Call often, at least once per output period. Ticks missed by a late
+     * call are merged into one event (at most IQS5XX_SCROLL_MAX_CATCH_UP).
+     * @param nowUs Current time, e.g. micros()
+     * @return true if an event was emitted (see event())
+     */
+    bool service(uint32_t nowUs);
+
+    /**
+     * @brief Event emitted by the last successful service()
+     */
+    const ScrollEvent& event() const { return _event; }
+
+    /**
+     * @brief Whether two fingers are scrolling
+     */
+    bool dragging() const { return _dragging; }
+
+    /**
+     * @brief Whether the stream is coasting after a release
+     */
+    bool coasting() const { return _coasting; }
+
+    /**
+     * @brief Stop dragging and coasting and drop pending movement
+     */
+    void stop();
+
+  private:
+    ScrollConfig _config;
+    uint32_t _decayQ16;           // Velocity factor per output tick
+    IQS5XX_ScrollCallback _callback;
+    void* _context;
+
+    bool _dragging;
+    bool _coasting;
+    uint8_t _ids[2];              // The two scrolling contacts
+    int32_t _centroidX, _centroidY;     // counts << 8
+    int32_t _pendingX, _pendingY;       // Drag movement not yet emitted, counts << 8
+    int32_t _velocityX, _velocityY;     // counts/s << IQS5XX_VELOCITY_SHIFT
+
+    bool _ticking;
+    uint32_t _nextTickUs;
+    int32_t _countX, _countY;           // Remainders, counts << 8
+    int32_t _detentX, _detentY;
+    ScrollEvent _event;
+
+    void release(const ContactFrame &contacts, const MotionFrame &motion);
+    static int8_t detents(int32_t &remainder, int16_t countsPerDetent);
+};
+
+#endif // IQS5XX_SCROLL_H
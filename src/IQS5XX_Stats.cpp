@@ -0,0 +1,53 @@
+/**
+ * @file IQS5XX_Stats.cpp
+ * @brief Serial dump of the instrumentation stats
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Stats.h"
+
+namespace {
+
+void printHistogram(Print &out, const char* name, const LatencyHistogram &histogram) {
+  out.print("iqs5xx ");
+  out.print(name);
+  out.print(" n=");
+  out.print((unsigned long)histogram.count);
+  out.print(" max=");
+  out.print((unsigned long)histogram.maxUs);
+  for (uint8_t i = 0; i < IQS5XX_HISTOGRAM_BUCKETS; i++) {
+    if (histogram.buckets[i] == 0) {
+      continue;
+    }
+    out.print(" <");
+    if (i == IQS5XX_HISTOGRAM_BUCKETS - 1) {
+      out.print("inf");
+    } else {
+      out.print(1UL << i);
+    }
+    out.print(':');
+    out.print((unsigned long)histogram.buckets[i]);
+  }
+  out.println();
+}
+
+} // namespace
+
+void IQS5XX_printStats(Print &out, const TrackpadStats &stats) {
+  out.print("iqs5xx transactions=");
+  out.print((unsigned long)stats.transactions);
+  out.print(" nacks=");
+  out.print((unsigned long)stats.nacks);
+  out.print(" timeouts=");
+  out.print((unsigned long)stats.timeouts);
+  out.print(" bytes_written=");
+  out.print((unsigned long)stats.bytesWritten);
+  out.print(" bytes_read=");
+  out.print((unsigned long)stats.bytesRead);
+  out.println();
+  printHistogram(out, "rdy_wait_us", stats.rdyWait);
+  printHistogram(out, "transfer_us", stats.transfer);
+  printHistogram(out, "decode_us", stats.decode);
+}
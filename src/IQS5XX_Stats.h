@@ -0,0 +1,140 @@
+/**
+ * @file IQS5XX_Stats.h
+ * @brief Optional per-transaction instrumentation with latency histograms
+ * @author lemio
+ *
+ * The stats policy is a template parameter of the trackpad:
+ * IQS5XX_InstrumentedTrackpad records into an IQS5XX_StatsRecorder, while
+ * IQS5XX_B000_Trackpad uses IQS5XX_NullStats, an empty base whose hooks
+ * are inline no-ops that compile away.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_STATS_H
+#define IQS5XX_STATS_H
+
+#include <Arduino.h>
+#include <string.h>
+
+// Latency buckets: bucket 0 holds < 1 us, bucket k holds [2^(k-1), 2^k) us
+// and the last bucket everything from 2^(IQS5XX_HISTOGRAM_BUCKETS-2) us up
+#define IQS5XX_HISTOGRAM_BUCKETS 18
+
+/**
+ * @brief log2-bucketed latency histogram
+ */
+struct LatencyHistogram {
+  uint32_t buckets[IQS5XX_HISTOGRAM_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+};
+
+/**
+ * @brief Snapshot returned by IQS5XX_B000_Trackpad::getStats()
+ */
+struct TrackpadStats {
+  uint32_t transactions;   // Addressed bus accesses
+  uint32_t nacks;          // Accesses that failed (NACK or short read)
+  uint32_t timeouts;       // RDY waits that ran out of budget
+  uint32_t bytesWritten;   // Including register address bytes
+  uint32_t bytesRead;
+  LatencyHistogram rdyWait;   // Time spent waiting for RDY
+  LatencyHistogram transfer;  // Time per bus access (submit to completion for backends)
+  LatencyHistogram decode;    // Time to decode a frame
+};
+
+/**
+ * @class IQS5XX_StatsRecorder
+ * @brief Stats policy that records everything
+ */
+class IQS5XX_StatsRecorder {
+  public:
+    static const bool enabled = true;
+
+    IQS5XX_StatsRecorder() { reset(); }
+
+    void reset() { memset(&_stats, 0, sizeof(_stats)); _transferStartUs = 0; }
+
+    /**
+     * @brief Timestamp for latency measurements
+     */
+    uint32_t now() const { return micros(); }
+
+    void startTransfer() { _transferStartUs = micros(); }
+
+    void transfer(uint8_t written, uint8_t read, bool ok) {
+      _stats.transactions++;
+      _stats.bytesWritten += written;
+      _stats.bytesRead += read;
+      if (!ok) {
+        _stats.nacks++;
+      }
+      add(_stats.transfer, micros() - _transferStartUs);
+    }
+
+    void rdyWait(uint32_t startUs, bool ready) {
+      if (ready) {
+        add(_stats.rdyWait, micros() - startUs);
+      } else {
+        _stats.timeouts++;
+      }
+    }
+
+    void decode(uint32_t startUs) { add(_stats.decode, micros() - startUs); }
+
+    const TrackpadStats& snapshot() const { return _stats; }
+
+  private:
+    TrackpadStats _stats;
+    uint32_t _transferStartUs;
+
+    static void add(LatencyHistogram &histogram, uint32_t us) {
+      uint8_t bucket = 0;
+      for (uint32_t rest = us; rest != 0 && bucket < IQS5XX_HISTOGRAM_BUCKETS - 1; rest >>= 1) {
+        bucket++;
+      }
+      histogram.buckets[bucket]++;
+      histogram.count++;
+      if (us > histogram.maxUs) {
+        histogram.maxUs = us;
+      }
+    }
+};
+
+/**
+ * @class IQS5XX_NullStats
+ * @brief Stats policy that records nothing and costs nothing
+ */
+class IQS5XX_NullStats {
+  public:
+    static const bool enabled = false;
+
+    void reset() {}
+    uint32_t now() const { return 0; }
+    void startTransfer() {}
+    void transfer(uint8_t, uint8_t, bool) {}
+    void rdyWait(uint32_t, bool) {}
+    void decode(uint32_t) {}
+
+    const TrackpadStats& snapshot() const {
+      static const TrackpadStats empty = {};
+      return empty;
+    }
+};
+
+/**
+ * @brief Write stats in the serial dump format
+ *
+ * One line of counters, then one line per histogram listing the non-empty
+ * buckets as `<upper bound in us>:<count>` ("inf" for the last bucket):
+ *
+ *   iqs5xx transactions=120 nacks=0 timeouts=2 bytes_written=260 bytes_read=1920
+ *   iqs5xx rdy_wait_us n=100 max=4990 <1:2 <4096:90 <8192:8
+ *
+ * @param out Serial or any other Print
+ * @param stats Snapshot to print
+ */
+void IQS5XX_printStats(Print &out, const TrackpadStats &stats);
+
+#endif // IQS5XX_STATS_H
@@ -0,0 +1,392 @@
+/**
+ * @file IQS5XX_Stream.cpp
+ * @brief Compact binary framing for streaming touch frames over a serial link
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_Stream.h"
+
+#include <string.h>
+
+namespace {
+
+// CRC-16/CCITT-FALSE remainders for one nibble
+const uint16_t kCrcNibble[16] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+void put16(uint8_t* p, uint16_t value) {
+  p[0] = value & 0xFF;
+  p[1] = value >> 8;
+}
+
+void put32(uint8_t* p, uint32_t value) {
+  put16(p, value & 0xFFFF);
+  put16(p + 2, value >> 16);
+}
+
+uint16_t get16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+uint32_t get32(const uint8_t* p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+// Longest delta before the keyframe fallback: header, channel, sequence,
+// 5-byte timestamp, fingers, gestures, and 3+3+3+2 varint bytes per slot
+const size_t kMaxDeltaPayload = 11 + IQS5XX_STREAM_MAX_SLOTS * 11;
+
+uint8_t* putVarint(uint8_t* p, uint32_t value) {
+  while (value >= 0x80) {
+    *p++ = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  *p++ = value;
+  return p;
+}
+
+bool getVarint(const uint8_t* &p, const uint8_t* end, uint32_t &value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (p >= end) {
+      return false;
+    }
+    uint8_t byte = *p++;
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Zig-zag mapping keeps small negative differences small
+uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Clamp counts and clear unused slots, so encoder and decoder hold the
+// same delta reference
+void normalize(IQS5XX_StreamFrame &frame) {
+  if (frame.slots > IQS5XX_STREAM_MAX_SLOTS) {
+    frame.slots = IQS5XX_STREAM_MAX_SLOTS;
+  }
+  if (frame.numFingers > 0x0F) {
+    frame.numFingers = 0x0F;
+  }
+  for (uint8_t i = frame.slots; i < IQS5XX_STREAM_MAX_SLOTS; i++) {
+    frame.x[i] = 0;
+    frame.y[i] = 0;
+    frame.strength[i] = 0;
+    frame.area[i] = 0;
+  }
+}
+
+} // namespace
+
+uint16_t IQS5XX_crc16(const uint8_t* data, size_t length, uint16_t crc) {
+  for (size_t i = 0; i < length; i++) {
+    crc = (crc << 4) ^ kCrcNibble[(crc >> 12) ^ (data[i] >> 4)];
+    crc = (crc << 4) ^ kCrcNibble[(crc >> 12) ^ (data[i] & 0x0F)];
+  }
+  return crc;
+}
+
+size_t IQS5XX_cobsEncode(const uint8_t* data, size_t length, uint8_t* out) {
+  size_t code = 0;   // Position of the pending code byte
+  size_t written = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] == 0) {
+      out[code] = (uint8_t)(written - code);
+      code = written++;
+    } else {
+      out[written++] = data[i];
+    }
+  }
+  out[code] = (uint8_t)(written - code);
+  return written;
+}
+
+size_t IQS5XX_cobsDecode(uint8_t* data, size_t length) {
+  size_t read = 0;
+  size_t written = 0;
+  while (read < length) {
+    uint8_t code = data[read++];
+    if (code == 0 || read + code - 1 > length) {
+      return 0;
+    }
+    for (uint8_t i = 1; i < code; i++) {
+      data[written++] = data[read++];
+    }
+    // A code below 0xFF stands for a zero, except at the end of the packet
+    if (code != 0xFF && read < length) {
+      data[written++] = 0;
+    }
+  }
+  return written;
+}
+
+IQS5XX_StreamEncoder::IQS5XX_StreamEncoder(uint8_t channel, uint8_t keyframeInterval)
+  : _channel(channel), _keyframeInterval(keyframeInterval), _sinceKeyframe(0), _sequence(0) {
+  memset(&_reference, 0, sizeof(_reference));
+}
+
+size_t IQS5XX_StreamEncoder::encode(const IQS5XX_StreamFrame &frame, uint8_t* packet) {
+  IQS5XX_StreamFrame current = frame;
+  normalize(current);
+  current.channel = _channel;
+  current.sequence = _sequence;
+
+  uint8_t payload[kMaxDeltaPayload];
+  size_t length;
+  if (_keyframeInterval == 0) {
+    length = encodeFull(current, IQS5XX_STREAM_TYPE_TOUCH, payload);
+  } else {
+    length = (_sinceKeyframe > 0) ? encodeDelta(current, payload) : 0;
+    if (length == 0) {
+      length = encodeFull(current, IQS5XX_STREAM_TYPE_KEYFRAME, payload);
+      _sinceKeyframe = 0;
+    }
+    if (++_sinceKeyframe >= _keyframeInterval) {
+      _sinceKeyframe = 0;
+    }
+    _reference = current;
+  }
+  _sequence++;
+
+  put16(payload + length, IQS5XX_crc16(payload, length));
+  length += IQS5XX_STREAM_CRC_LENGTH;
+  size_t encoded = IQS5XX_cobsEncode(payload, length, packet);
+  packet[encoded++] = 0x00;
+  return encoded;
+}
+
+size_t IQS5XX_StreamEncoder::encodeFull(const IQS5XX_StreamFrame &frame, uint8_t type, uint8_t* payload) {
+  uint8_t* p = payload;
+  *p++ = (IQS5XX_STREAM_VERSION << 4) | type;
+  if (type == IQS5XX_STREAM_TYPE_KEYFRAME) {
+    *p++ = frame.channel;
+  }
+  put16(p, frame.sequence);
+  put32(p + 2, frame.timestampUs);
+  p[6] = frame.numFingers | (frame.slots << 4);
+  p[7] = frame.gestureEvents0;
+  p[8] = frame.gestureEvents1;
+  p += IQS5XX_STREAM_HEADER_LENGTH - 1;
+
+  for (uint8_t i = 0; i < frame.slots; i++) {
+    put16(p, frame.x[i]);
+    put16(p + 2, frame.y[i]);
+    put16(p + 4, frame.strength[i]);
+    p[6] = frame.area[i];
+    p += IQS5XX_STREAM_SLOT_LENGTH;
+  }
+  return p - payload;
+}
+
+size_t IQS5XX_StreamEncoder::encodeDelta(const IQS5XX_StreamFrame &frame, uint8_t* payload) {
+  bool gestures = frame.gestureEvents0 != 0 || frame.gestureEvents1 != 0;
+
+  uint8_t* p = payload;
+  *p++ = (IQS5XX_STREAM_VERSION << 4) | IQS5XX_STREAM_TYPE_DELTA;
+  *p++ = frame.channel;
+  *p++ = frame.sequence & 0xFF;
+  p = putVarint(p, frame.timestampUs - _reference.timestampUs);
+  *p++ = frame.numFingers | (frame.slots << 4) | (gestures ? 0x80 : 0);
+  if (gestures) {
+    *p++ = frame.gestureEvents0;
+    *p++ = frame.gestureEvents1;
+  }
+
+  // Differences wrap, so a full-range jump still round-trips
+  for (uint8_t i = 0; i < frame.slots; i++) {
+    p = putVarint(p, zigzag((int16_t)(frame.x[i] - _reference.x[i])));
+    p = putVarint(p, zigzag((int16_t)(frame.y[i] - _reference.y[i])));
+    p = putVarint(p, zigzag((int16_t)(frame.strength[i] - _reference.strength[i])));
+    p = putVarint(p, zigzag((int8_t)(frame.area[i] - _reference.area[i])));
+  }
+
+  // Not worth it if the keyframe is as small
+  size_t keyframe = 1 + IQS5XX_STREAM_HEADER_LENGTH + frame.slots * IQS5XX_STREAM_SLOT_LENGTH;
+  size_t length = p - payload;
+  return (length < keyframe) ? length : 0;
+}
+
+IQS5XX_StreamDecoder::IQS5XX_StreamDecoder() {
+  reset();
+}
+
+void IQS5XX_StreamDecoder::reset() {
+  _length = 0;
+  _overflow = false;
+  memset(&_frame, 0, sizeof(_frame));
+  memset(&_stats, 0, sizeof(_stats));
+  memset(_reference, 0, sizeof(_reference));
+  memset(_haveSequence, 0, sizeof(_haveSequence));
+  memset(_referenceValid, 0, sizeof(_referenceValid));
+}
+
+bool IQS5XX_StreamDecoder::push(uint8_t byte) {
+  if (byte != 0x00) {
+    if (_length < sizeof(_buffer)) {
+      _buffer[_length++] = byte;
+    } else {
+      _overflow = true;
+    }
+    return false;
+  }
+
+  // Delimiter: whatever was collected is one packet
+  bool valid = false;
+  if (_overflow) {
+    _stats.framingErrors++;
+  } else if (_length > 0) {
+    valid = decodePacket();
+  }
+  _length = 0;
+  _overflow = false;
+  return valid;
+}
+
+bool IQS5XX_StreamDecoder::decodePacket() {
+  size_t length = IQS5XX_cobsDecode(_buffer, _length);
+  if (length < 2 + IQS5XX_STREAM_CRC_LENGTH) {
+    _stats.framingErrors++;
+    return false;
+  }
+  size_t payload = length - IQS5XX_STREAM_CRC_LENGTH;
+  if (IQS5XX_crc16(_buffer, payload) != get16(_buffer + payload)) {
+    _stats.crcErrors++;
+    return false;
+  }
+
+  bool valid = false;
+  if ((_buffer[0] >> 4) == IQS5XX_STREAM_VERSION) {
+    switch (_buffer[0] & 0x0F) {
+      case IQS5XX_STREAM_TYPE_TOUCH:
+        valid = decodeFull(_buffer + 1, payload - 1, 0);
+        break;
+      case IQS5XX_STREAM_TYPE_KEYFRAME:
+        valid = _buffer[1] < IQS5XX_STREAM_MAX_CHANNELS &&
+                decodeFull(_buffer + 2, payload - 2, _buffer[1]);
+        break;
+      case IQS5XX_STREAM_TYPE_DELTA:
+        // Counts its own errors, a skipped delta is not a framing error
+        return decodeDelta(_buffer + 1, payload - 1);
+    }
+  }
+  if (!valid) {
+    _stats.framingErrors++;
+  }
+  return valid;
+}
+
+bool IQS5XX_StreamDecoder::decodeFull(const uint8_t* p, size_t length, uint8_t channel) {
+  if (length < IQS5XX_STREAM_HEADER_LENGTH - 1) {
+    return false;
+  }
+  uint8_t slots = p[6] >> 4;
+  if (slots > IQS5XX_STREAM_MAX_SLOTS ||
+      length != (size_t)(IQS5XX_STREAM_HEADER_LENGTH - 1 + slots * IQS5XX_STREAM_SLOT_LENGTH)) {
+    return false;
+  }
+
+  IQS5XX_StreamFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.channel = channel;
+  frame.sequence = get16(p);
+  frame.timestampUs = get32(p + 2);
+  frame.numFingers = p[6] & 0x0F;
+  frame.slots = slots;
+  frame.gestureEvents0 = p[7];
+  frame.gestureEvents1 = p[8];
+  const uint8_t* slot = p + IQS5XX_STREAM_HEADER_LENGTH - 1;
+  for (uint8_t i = 0; i < slots; i++) {
+    frame.x[i] = get16(slot);
+    frame.y[i] = get16(slot + 2);
+    frame.strength[i] = get16(slot + 4);
+    frame.area[i] = slot[6];
+    slot += IQS5XX_STREAM_SLOT_LENGTH;
+  }
+  accept(frame);
+  return true;
+}
+
+bool IQS5XX_StreamDecoder::decodeDelta(const uint8_t* p, size_t length) {
+  const uint8_t* end = p + length;
+  if (length < 4 || p[0] >= IQS5XX_STREAM_MAX_CHANNELS) {
+    _stats.framingErrors++;
+    return false;
+  }
+  uint8_t channel = p[0];
+
+  // Only applies on top of the frame right before it
+  const IQS5XX_StreamFrame &reference = _reference[channel];
+  if (!_referenceValid[channel] || p[1] != ((reference.sequence + 1) & 0xFF)) {
+    _referenceValid[channel] = false;
+    _stats.skippedDeltas++;
+    return false;
+  }
+  p += 2;
+
+  IQS5XX_StreamFrame frame = reference;
+  frame.sequence = reference.sequence + 1;
+  uint32_t value;
+  bool valid = getVarint(p, end, value) && p < end;
+  if (valid) {
+    frame.timestampUs = reference.timestampUs + value;
+    frame.numFingers = *p & 0x0F;
+    frame.slots = (*p >> 4) & 0x07;
+    bool gestures = *p++ & 0x80;
+    frame.gestureEvents0 = 0;
+    frame.gestureEvents1 = 0;
+    if (gestures) {
+      valid = end - p >= 2;
+      if (valid) {
+        frame.gestureEvents0 = p[0];
+        frame.gestureEvents1 = p[1];
+        p += 2;
+      }
+    }
+    valid = valid && frame.slots <= IQS5XX_STREAM_MAX_SLOTS;
+  }
+  for (uint8_t i = 0; valid && i < frame.slots; i++) {
+    uint32_t dx = 0, dy = 0, dstrength = 0, darea = 0;
+    valid = getVarint(p, end, dx) && getVarint(p, end, dy) &&
+            getVarint(p, end, dstrength) && getVarint(p, end, darea);
+    frame.x[i] += unzigzag(dx);
+    frame.y[i] += unzigzag(dy);
+    frame.strength[i] += unzigzag(dstrength);
+    frame.area[i] += unzigzag(darea);
+  }
+  if (!valid || p != end) {
+    // Passed the CRC but does not parse: do not build on it
+    _referenceValid[channel] = false;
+    _stats.framingErrors++;
+    return false;
+  }
+
+  normalize(frame);
+  accept(frame);
+  return true;
+}
+
+void IQS5XX_StreamDecoder::accept(const IQS5XX_StreamFrame &frame) {
+  uint8_t channel = frame.channel;
+  if (_haveSequence[channel]) {
+    _stats.droppedFrames += (uint16_t)(frame.sequence - _reference[channel].sequence - 1);
+  }
+  _haveSequence[channel] = true;
+  _referenceValid[channel] = true;
+  _reference[channel] = frame;
+  _frame = frame;
+  _stats.frames++;
+}
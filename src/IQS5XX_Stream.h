@@ -0,0 +1,231 @@
+/**
+ * @file IQS5XX_Stream.h
+ * @brief Compact binary framing for streaming touch frames over a serial link
+ * @author lemio
+ *
+ * Does not depend on Arduino, so the same encoder and decoder build on the
+ * MCU and in host tools. A packet is the payload below followed by a
+ * CRC-16/CCITT-FALSE over the payload, COBS encoded and terminated by a
+ * 0x00 delimiter. Multi-byte fields are little-endian.
+ *
+ *   offset  size  field
+ *   0       1     header: version << 4 | IQS5XX_STREAM_TYPE_*
+ *   1       2     sequence number (wraps, gaps count as dropped frames)
+ *   3       4     timestamp in microseconds (wraps)
+ *   7       1     fingers: number of fingers (low nibble), slots carried (high nibble)
+ *   8       1     GESTURE_EVENTS_0
+ *   9       1     GESTURE_EVENTS_1
+ *   10      7*n   per slot: x (2), y (2), strength (2), area (1)
+ *   10+7*n  2     CRC
+ *
+ * A five-finger frame is 49 bytes on the wire, so 200 Hz fits in a
+ * 115200 baud UART (11520 bytes/s).
+ *
+ * With compression enabled (keyframe interval > 0) the encoder sends a
+ * keyframe every N frames and delta packets in between. Both carry a
+ * channel number so several pads can share one link:
+ *
+ *   keyframe (IQS5XX_STREAM_TYPE_KEYFRAME): header, channel (1), then the
+ *   touch packet fields from the sequence number on
+ *
+ *   delta (IQS5XX_STREAM_TYPE_DELTA):
+ *   0       1     header
+ *   1       1     channel
+ *   2       1     low byte of the sequence number
+ *   3       1-5   timestamp increment in microseconds (varint)
+ *   +0      1     fingers (low nibble), slots (bits 4-6), gesture bytes follow (bit 7)
+ *   +1      0/2   GESTURE_EVENTS_0, GESTURE_EVENTS_1
+ *   +n      ...   per slot: x, y, strength, area as zig-zag varint
+ *                 differences to the same slot of the previous frame
+ *   end     2     CRC
+ *
+ * A delta only applies on top of the frame right before it, so after a
+ * lost packet the decoder drops deltas of that channel until the next
+ * keyframe. A resting finger costs 4 bytes per frame instead of 7.
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_STREAM_H
+#define IQS5XX_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IQS5XX_STREAM_VERSION       1
+#define IQS5XX_STREAM_TYPE_TOUCH    0x01    // Full frame, channel 0
+#define IQS5XX_STREAM_TYPE_KEYFRAME 0x02    // Full frame with channel number
+#define IQS5XX_STREAM_TYPE_DELTA    0x03    // Differences to the previous frame
+
+// Channels (pads) the decoder keeps delta references for
+#ifndef IQS5XX_STREAM_MAX_CHANNELS
+#define IQS5XX_STREAM_MAX_CHANNELS  4
+#endif
+
+// Finger slots a packet can carry (matches IQS5XX_MAX_FINGERS)
+#define IQS5XX_STREAM_MAX_SLOTS     5
+#define IQS5XX_STREAM_HEADER_LENGTH 10
+#define IQS5XX_STREAM_SLOT_LENGTH   7
+#define IQS5XX_STREAM_CRC_LENGTH    2
+// Keyframes are the largest packets: the encoder never sends a delta that
+// is longer than the keyframe it replaces
+#define IQS5XX_STREAM_MAX_PAYLOAD   (1 + IQS5XX_STREAM_HEADER_LENGTH + \
+                                     IQS5XX_STREAM_MAX_SLOTS * IQS5XX_STREAM_SLOT_LENGTH + \
+                                     IQS5XX_STREAM_CRC_LENGTH)
+// COBS code byte plus delimiter (payloads stay below 254 bytes)
+#define IQS5XX_STREAM_MAX_PACKET    (IQS5XX_STREAM_MAX_PAYLOAD + 2)
+
+/**
+ * @brief One touch frame as carried by the stream
+ *
+ * Only the first `slots` entries of the per-finger arrays are valid.
+ */
+struct IQS5XX_StreamFrame {
+  uint8_t channel;          // Pad the frame belongs to (0 for touch packets)
+  uint16_t sequence;
+  uint32_t timestampUs;
+  uint8_t numFingers;       // Fingers reported by the device
+  uint8_t slots;            // Finger slots carried (<= IQS5XX_STREAM_MAX_SLOTS)
+  uint8_t gestureEvents0;
+  uint8_t gestureEvents1;
+  uint16_t x[IQS5XX_STREAM_MAX_SLOTS];
+  uint16_t y[IQS5XX_STREAM_MAX_SLOTS];
+  uint16_t strength[IQS5XX_STREAM_MAX_SLOTS];
+  uint8_t area[IQS5XX_STREAM_MAX_SLOTS];
+};
+
+/**
+ * @brief Decoder counters
+ */
+struct IQS5XX_StreamStats {
+  uint32_t frames;          // Packets decoded successfully
+  uint32_t crcErrors;       // Packets with a bad CRC
+  uint32_t framingErrors;   // Bad COBS, unknown header, wrong length or overlong packets
+  uint32_t droppedFrames;   // Frames missing according to the sequence numbers
+  uint32_t skippedDeltas;   // Deltas discarded while waiting for a keyframe
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ * @param crc Running CRC, to checksum data in several pieces
+ * @return Updated CRC
+ */
+uint16_t IQS5XX_crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief COBS-encode a buffer (without the trailing delimiter)
+ * @param data Bytes to encode, at most 253
+ * @param length Number of bytes
+ * @param out Destination, at least length + 1 bytes; must not overlap data
+ * @return Number of encoded bytes
+ */
+size_t IQS5XX_cobsEncode(const uint8_t* data, size_t length, uint8_t* out);
+
+/**
+ * @brief COBS-decode a packet in place (without the trailing delimiter)
+ * @param data Encoded bytes, replaced by the decoded bytes
+ * @param length Number of encoded bytes
+ * @return Number of decoded bytes, or 0 if the packet is malformed
+ */
+size_t IQS5XX_cobsDecode(uint8_t* data, size_t length);
+
+/**
+ * @class IQS5XX_StreamEncoder
+ * @brief Packs frames into delimited packets and numbers them
+ */
+class IQS5XX_StreamEncoder {
+  public:
+    /**
+     * @brief Constructor
+     * @param channel Channel number sent with keyframes and deltas
+     * @param keyframeInterval Frames per keyframe with compression, or 0 to
+     *                         send every frame as a full touch packet
+     */
+    explicit IQS5XX_StreamEncoder(uint8_t channel = 0, uint8_t keyframeInterval = 0);
+
+    /**
+     * @brief Encode a frame into one packet, including the delimiter
+     *
+     * The frame's sequence and channel fields are ignored; packets are
+     * numbered by the encoder.
+     * @param frame Frame to send
+     * @param packet Destination, at least IQS5XX_STREAM_MAX_PACKET bytes
+     * @return Packet length in bytes
+     */
+    size_t encode(const IQS5XX_StreamFrame &frame, uint8_t* packet);
+
+    /**
+     * @brief Send the next frame as a keyframe (e.g. after the receiver reconnected)
+     */
+    void forceKeyframe() { _sinceKeyframe = 0; }
+
+    /**
+     * @brief Sequence number of the next packet
+     */
+    uint16_t sequence() const { return _sequence; }
+
+  private:
+    uint8_t _channel;
+    uint8_t _keyframeInterval;
+    uint8_t _sinceKeyframe;     // Frames since the last keyframe, 0 = keyframe due
+    uint16_t _sequence;
+    IQS5XX_StreamFrame _reference;  // Last frame sent, base of the next delta
+
+    size_t encodeFull(const IQS5XX_StreamFrame &frame, uint8_t type, uint8_t* payload);
+    size_t encodeDelta(const IQS5XX_StreamFrame &frame, uint8_t* payload);
+};
+
+/**
+ * @class IQS5XX_StreamDecoder
+ * @brief Byte-at-a-time packet decoder that resynchronizes on delimiters
+ *
+ * Corrupted or truncated packets are dropped at the next 0x00 delimiter,
+ * so decoding recovers by itself after lost bytes.
+ */
+class IQS5XX_StreamDecoder {
+  public:
+    IQS5XX_StreamDecoder();
+
+    /**
+     * @brief Feed one received byte
+     * @param byte Byte from the serial stream
+     * @return true if the byte completed a valid packet, now in frame()
+     */
+    bool push(uint8_t byte);
+
+    /**
+     * @brief Most recently decoded frame
+     */
+    const IQS5XX_StreamFrame& frame() const { return _frame; }
+
+    /**
+     * @brief Decoder counters since construction or reset()
+     */
+    const IQS5XX_StreamStats& stats() const { return _stats; }
+
+    /**
+     * @brief Drop any partial packet and clear the counters
+     */
+    void reset();
+
+  private:
+    uint8_t _buffer[IQS5XX_STREAM_MAX_PACKET];
+    uint8_t _length;
+    bool _overflow;
+    IQS5XX_StreamFrame _frame;
+    IQS5XX_StreamStats _stats;
+
+    // Last frame per channel: sequence tracking and delta reference
+    IQS5XX_StreamFrame _reference[IQS5XX_STREAM_MAX_CHANNELS];
+    bool _haveSequence[IQS5XX_STREAM_MAX_CHANNELS];
+    bool _referenceValid[IQS5XX_STREAM_MAX_CHANNELS];
+
+    bool decodePacket();
+    bool decodeFull(const uint8_t* payload, size_t length, uint8_t channel);
+    bool decodeDelta(const uint8_t* payload, size_t length);
+    void accept(const IQS5XX_StreamFrame &frame);
+};
+
+#endif // IQS5XX_STREAM_H
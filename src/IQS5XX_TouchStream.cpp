@@ -0,0 +1,68 @@
+/**
+ * @file IQS5XX_TouchStream.cpp
+ * @brief Writes touch frames to Serial as binary stream packets
+ * @author lemio
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#include "IQS5XX_TouchStream.h"
+
+bool IQS5XX_TouchStream::write(const TouchData &touchData, uint32_t timestampUs) {
+  IQS5XX_StreamFrame frame;
+  toStreamFrame(touchData, frame);
+  return send(frame, timestampUs);
+}
+
+bool IQS5XX_TouchStream::write(const MultiTouchFrame &multiTouch, uint32_t timestampUs) {
+  IQS5XX_StreamFrame frame;
+  toStreamFrame(multiTouch, frame);
+  return send(frame, timestampUs);
+}
+
+bool IQS5XX_TouchStream::send(IQS5XX_StreamFrame &frame, uint32_t timestampUs) {
+  // The acquisition time, so queueing and serial backpressure do not show
+  // up as jitter on the receiving side
+  frame.timestampUs = timestampUs;
+  uint8_t packet[IQS5XX_STREAM_MAX_PACKET];
+  size_t length = _encoder.encode(frame, packet);
+  if (_out->write(packet, length) != length) {
+    // The receiver cannot apply deltas on top of a lost packet
+    _encoder.forceKeyframe();
+    return false;
+  }
+  return true;
+}
+
+void IQS5XX_TouchStream::toStreamFrame(const TouchData &touchData, IQS5XX_StreamFrame &frame) {
+  frame.channel = 0;
+  frame.sequence = 0;
+  frame.timestampUs = 0;
+  frame.numFingers = touchData.numFingers;
+  frame.slots = (touchData.state != NO_TOUCH) ? 1 : 0;
+  // Back to the GESTURE_EVENTS_0/1 bit layout
+  frame.gestureEvents0 = (touchData.swipeY_minus << 5) | (touchData.swipeY_plus << 4) |
+                         (touchData.swipeX_plus << 3) | (touchData.swipeX_minus << 2) |
+                         (touchData.pressAndHold << 1) | touchData.singleTap;
+  frame.gestureEvents1 = (touchData.zoom << 2) | (touchData.scroll << 1) | touchData.twoFingerTap;
+  frame.x[0] = touchData.x;
+  frame.y[0] = touchData.y;
+  frame.strength[0] = touchData.touchStrength;
+  frame.area[0] = touchData.area;
+}
+
+void IQS5XX_TouchStream::toStreamFrame(const MultiTouchFrame &multiTouch, IQS5XX_StreamFrame &frame) {
+  frame.channel = 0;
+  frame.sequence = 0;
+  frame.timestampUs = 0;
+  frame.numFingers = multiTouch.numFingers;
+  frame.slots = (multiTouch.numFingers > IQS5XX_STREAM_MAX_SLOTS) ? IQS5XX_STREAM_MAX_SLOTS : multiTouch.numFingers;
+  frame.gestureEvents0 = multiTouch.gestureEvents0;
+  frame.gestureEvents1 = multiTouch.gestureEvents1;
+  for (uint8_t i = 0; i < IQS5XX_STREAM_MAX_SLOTS; i++) {
+    frame.x[i] = multiTouch.x[i];
+    frame.y[i] = multiTouch.y[i];
+    frame.strength[i] = multiTouch.strength[i];
+    frame.area[i] = multiTouch.area[i];
+  }
+}
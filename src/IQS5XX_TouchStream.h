@@ -0,0 +1,74 @@
+/**
+ * @file IQS5XX_TouchStream.h
+ * @brief Writes touch frames to Serial as binary stream packets
+ * @author lemio
+ *
+ * Arduino side of IQS5XX_Stream.h: converts TouchData and MultiTouchFrame
+ * into stream frames stamped with the time they were read and sends each
+ * packet with a single write(). Decode with IQS5XX_StreamDecoder on the host (see
+ * extras/host/stream_decode.cpp).
+ *
+ * @copyright This project is licensed under the GNU General Public License v3.0
+ */
+
+#ifndef IQS5XX_TOUCH_STREAM_H
+#define IQS5XX_TOUCH_STREAM_H
+
+#include <Arduino.h>
+#include "IQS5XX_B000_Trackpad.h"
+#include "IQS5XX_Stream.h"
+
+/**
+ * @class IQS5XX_TouchStream
+ * @brief Binary touch frame writer for any Print (Serial, a file, ...)
+ */
+class IQS5XX_TouchStream {
+  public:
+    /**
+     * @brief Constructor
+     * @param out Destination of the packets
+     * @param channel Pad number, to share one link between several trackpads
+     * @param keyframeInterval Frames per keyframe for delta compression, 0 to
+     *                         send full frames only (see IQS5XX_Stream.h)
+     */
+    explicit IQS5XX_TouchStream(Print &out, uint8_t channel = 0, uint8_t keyframeInterval = 0)
+      : _out(&out), _encoder(channel, keyframeInterval) {}
+
+    /**
+     * @brief Send the first finger and gesture events of a frame
+     * @param touchData Frame from readTouchData(), update() or popFrame()
+     * @param timestampUs Time the frame was read, e.g. micros()
+     * @return true if the whole packet was written, false otherwise
+     */
+    bool write(const TouchData &touchData, uint32_t timestampUs);
+
+    /**
+     * @brief Send every present finger slot and the gesture events of a frame
+     * @param frame Frame from readMultiTouch()
+     * @param timestampUs Time the frame was read, e.g. micros()
+     * @return true if the whole packet was written, false otherwise
+     */
+    bool write(const MultiTouchFrame &frame, uint32_t timestampUs);
+
+    /**
+     * @brief Convert a single-finger frame to a stream frame
+     * @param touchData Decoded frame
+     * @param frame Stream frame to fill (one slot if a finger is present)
+     */
+    static void toStreamFrame(const TouchData &touchData, IQS5XX_StreamFrame &frame);
+
+    /**
+     * @brief Convert a multi-touch frame to a stream frame
+     * @param multiTouch Decoded frame
+     * @param frame Stream frame to fill (one slot per finger)
+     */
+    static void toStreamFrame(const MultiTouchFrame &multiTouch, IQS5XX_StreamFrame &frame);
+
+  private:
+    Print* _out;
+    IQS5XX_StreamEncoder _encoder;
+
+    bool send(IQS5XX_StreamFrame &frame, uint32_t timestampUs);
+};
+
+#endif // IQS5XX_TOUCH_STREAM_H